@@ -6,7 +6,10 @@ import platform
 import subprocess
 import sys
 
-RELEASE = len(sys.argv) > 1 and sys.argv[1] == 'release'
+# build.py [release] [target...]; builds every target when none are named,
+# so `build.py robot` is a quick rebuild of just the robot program
+RELEASE = 'release' in sys.argv[1:]
+TARGETS = [a for a in sys.argv[1:] if a != 'release'] or ['robosim', 'robosim_bench', 'robot', 'hal_robot']
 
 user_os = platform.system().lower()
 user_arch = platform.machine().lower()
@@ -20,7 +23,6 @@ if user_os == 'windows':
     cxx = 'cl'
     opt = '/O2' if RELEASE else '/Od'
     cxxflags += [
-        '/Fe:', 'robosim', '/Fd:', 'robosim',
         '/std:c++20', opt,
         '/I..\\src', '/I..\\include',
     ]
@@ -31,27 +33,44 @@ if user_os == 'windows':
     ldflags += [
         '/Zi',
         '/MT', # use static multithreaded runtime library
-        winlib('raylib.lib'), winlib('box2d.lib'), winlib('glfw3_mt.lib'),
+    ]
+    box2d_libs = [winlib('box2d.lib')]
+    raylib_libs = [
+        winlib('raylib.lib'), winlib('glfw3_mt.lib'),
         'gdi32.lib', 'shell32.lib', 'winmm.lib',
     ]
+
+    shared_flags = ['/LD']
+    shared_ext = '.dll'
+    sim_libs = []
+
+    def output_flags(name):
+        return ['/Fe:', name, '/Fd:', name]
 elif user_os == 'darwin' or user_os == 'linux':
     cxx = 'clang++'
     opt = '-O2' if RELEASE else '-O0'
     cxxflags += [
-        '-orobosim',
-        '-std=c++20', opt, '-Wall', '-Wextra', '-pedantic',
+        '-std=c++20', opt, '-Wall', '-Wextra', '-pedantic', '-pthread',
         '-I../src', '-I../include',
     ]
-    ldflags += [
-        '-lraylib', '-lbox2d',
-    ]
+    box2d_libs = ['-lbox2d']
+    raylib_libs = ['-lraylib']
     if user_os == 'darwin':
-        ldflags += ['-framework', 'Cocoa', '-framework', 'IOKit']
+        raylib_libs += ['-framework', 'Cocoa', '-framework', 'IOKit']
+
+    shared_flags = ['-shared', '-fPIC']
+    shared_ext = '.dylib' if user_os == 'darwin' else '.so'
+    # dlopen for robot programs and shm_open for the HAL bridge; part of
+    # libc itself on newer glibc
+    sim_libs = ['-ldl', '-lrt'] if user_os == 'linux' else []
+
+    def output_flags(name):
+        return ['-o' + name]
 
 if user_os == 'windows' and user_arch == 'amd64':
     pass # todo: library search location? would be nice to remove the winlib nonsense from above
 elif user_os == 'darwin' and user_arch == 'arm64':
-    ldflags += ['-lglfw3']
+    raylib_libs += ['-lglfw3']
     ldflags += ['-L../lib/mac-arm64']
 elif user_os == 'linux' and user_arch == 'amd64':
     ldflags += ['-L../lib/linux-amd64']
@@ -61,10 +80,41 @@ else:
 
 os.makedirs('build', exist_ok=True)
 os.chdir('build')
-cfiles = glob.glob('../src/**/*.cpp', recursive=True)
-subprocess.run(
-    [cxx]
-    + cxxflags
-    + cfiles
-    + ldflags
-)
+
+def build(name, cfiles, libs, extra_flags=[]):
+    if name not in TARGETS and os.path.splitext(name)[0] not in TARGETS:
+        return
+    subprocess.run(
+        [cxx]
+        + output_flags(name)
+        + extra_flags
+        + cxxflags
+        + cfiles
+        + ldflags
+        + libs
+    )
+
+# the sim is everything except the bench; the bench only needs Box2D, the
+# scene builders and the piece pool, so it doesn't drag in raylib or open a
+# window
+all_cfiles = glob.glob('../src/**/*.cpp', recursive=True)
+bench_cfiles = glob.glob('../src/bench/*.cpp')
+bench_paths = {os.path.normpath(f) for f in bench_cfiles}
+build('robosim',
+      [f for f in all_cfiles if os.path.normpath(f) not in bench_paths],
+      raylib_libs + box2d_libs + sim_libs)
+build('robosim_bench',
+      bench_cfiles + ['../src/robosim/scenes.cpp', '../src/robosim/game_pieces.cpp'],
+      box2d_libs)
+
+# the robot program is its own library, loaded (and reloaded) with --robot
+build('robot' + shared_ext,
+      glob.glob('../robot/*.cpp'),
+      [],
+      shared_flags)
+
+# an example external robot process for --hal; POSIX shared memory only
+if user_os != 'windows':
+    build('hal_robot',
+          glob.glob('../robot/hal/*.cpp'),
+          ['-lrt'] if user_os == 'linux' else [])
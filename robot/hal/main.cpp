@@ -0,0 +1,68 @@
+// An example robot process for --hal: attaches to the sim's shared memory
+// and runs the drive-straight controller once per robot loop. Real robot
+// code does the same thing behind its HAL.
+//
+//   robosim --hal robosim &
+//   hal_robot robosim
+
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <string>
+#include <thread>
+
+#include "robosim/hal_shm.hpp"
+
+// the sim's robot loop and tuning, see robot.hpp and sim.hpp
+constexpr float kPeriod = 0.02f;
+constexpr float kTuningRate = 60.0f;
+constexpr float kFieldHeight = 720.0f;
+
+static std::atomic<bool> running{true};
+
+static void onSignal(int) {
+	running.store(false);
+}
+
+int main(int argc, char** argv) {
+	char const* name = argc > 1 ? argv[1] : "robosim";
+	std::string shmName = name[0] == '/' ? name : std::string("/") + name;
+
+	signal(SIGINT, onSignal);
+	signal(SIGTERM, onSignal);
+
+	HalClient hal;
+	while (!hal.open(shmName.c_str())) {
+		if (!running.load()) {
+			return 1;
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	}
+	printf("attached to %s\n", shmName.c_str());
+
+	long loops = 0;
+	HalSensors s;
+	while (hal.waitSensors(s, running)) {
+		// gains were tuned per 60 fps frame, so scale them to the robot loop
+		float k = kPeriod * kTuningRate;
+		float turn = k * (2.0f - std::abs(s.encoderRate / 2));
+
+		HalOutputs out{s.tick, 0, 0};
+		if (s.encoderRate < 2) {
+			out.accel += k * 0.06f;
+		}
+		out.turn += s.posY > kFieldHeight / 2 ? -turn : turn;
+
+		if (s.buttons & 1) out.turn -= turn;
+		if (s.buttons & 2) out.turn += turn;
+		if (s.buttons & 4) out.accel += k * 0.06f;
+		if (s.buttons & 8) out.accel -= k * 0.06f;
+
+		hal.sendOutputs(out);
+		loops++;
+	}
+
+	printf("detached after %ld loops\n", loops);
+	return 0;
+}
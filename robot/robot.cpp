@@ -0,0 +1,56 @@
+// The robot program, built on its own as a shared library (build.py robot)
+// and loaded with --robot. Rebuild while the sim is running and it picks up
+// the new build within a second, without losing its place.
+
+#include <cmath>
+#include <cstring>
+
+#include "robosim/robot_abi.hpp"
+
+// everything the program remembers between loops lives in ctx->memory,
+// which survives reloads
+struct State {
+	long loops;
+};
+static_assert(sizeof(State) <= sizeof(RobotContext::memory));
+static_assert(alignof(State) <= 16);
+
+static State& state(RobotContext* ctx) {
+	return *reinterpret_cast<State*>(ctx->memory);
+}
+
+ROBOT_EXPORT int robotInit(RobotContext* ctx) {
+	if (ctx->abiVersion != ROBOT_ABI_VERSION) {
+		return 1;
+	}
+	if (!ctx->reloaded) {
+		memset(&state(ctx), 0, sizeof(State));
+	}
+	return 0;
+}
+
+ROBOT_EXPORT void robotPeriodic(RobotContext* ctx, RobotLoopIo* io) {
+	state(ctx).loops++;
+
+	// gains were tuned per 60 fps frame, so scale them to the robot loop
+	float k = ctx->period * ctx->tuningRate;
+	float turn = k * (2.0f - std::abs(io->vel / 2));
+
+	// lets try to drive straight, naively
+
+	if (io->sensedVel < 2) {
+		io->vel += k * 0.06f;
+	}
+
+	if (io->sensedPosY > ctx->fieldHeight / 2) {
+		io->angle -= turn;
+	} else {
+		io->angle += turn;
+	}
+
+	if (io->left) io->angle -= turn;
+	if (io->right) io->angle += turn;
+
+	if (io->up) io->vel += k * 0.06f;
+	if (io->down) io->vel -= k * 0.06f;
+}
@@ -1,7 +1,39 @@
 #include "b2DrawRayLib.hpp"
 
+// RayLib
+#include <rlgl.h>
+
 // C++
-#include <vector>
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // same tessellation raylib uses for small circles
+    constexpr int kCircleSegments = 36;
+
+    struct UnitCircle
+    {
+        float x[kCircleSegments + 1];
+        float y[kCircleSegments + 1];
+
+        UnitCircle() noexcept
+        {
+            for (int i = 0; i <= kCircleSegments; ++i)
+            {
+                auto const angle = 2.0f * PI * i / kCircleSegments;
+                x[i] = std::cos(angle);
+                y[i] = std::sin(angle);
+            }
+        }
+    };
+
+    UnitCircle const unitCircle;
+
+    // a multiple of both 2 and 3 that sits comfortably inside rlgl's
+    // default vertex buffer
+    constexpr size_t kChunkVertices = 6144;
+}
 
 b2DrawRayLib::b2DrawRayLib(float scale) noexcept
     : m_scale { scale }
@@ -30,10 +62,106 @@ float b2DrawRayLib::GetScale() noexcept
     return m_scale;
 }
 
+b2AABB b2DrawRayLib::GetVisibleAABB(Camera2D const& camera, float screenWidth, float screenHeight) const noexcept
+{
+    Vector2 const corners[4] = {
+        GetScreenToWorld2D({ 0.0f, 0.0f }, camera),
+        GetScreenToWorld2D({ screenWidth, 0.0f }, camera),
+        GetScreenToWorld2D({ screenWidth, screenHeight }, camera),
+        GetScreenToWorld2D({ 0.0f, screenHeight }, camera),
+    };
+
+    // the camera may be rotated, so take the bounds of all four corners
+    b2AABB aabb;
+    aabb.lowerBound = { corners[0].x, corners[0].y };
+    aabb.upperBound = aabb.lowerBound;
+    for (auto const& c : corners)
+    {
+        aabb.lowerBound = b2Min(aabb.lowerBound, { c.x, c.y });
+        aabb.upperBound = b2Max(aabb.upperBound, { c.x, c.y });
+    }
+
+    aabb.lowerBound *= 1.0f / m_scale;
+    aabb.upperBound *= 1.0f / m_scale;
+    return aabb;
+}
+
+void b2DrawRayLib::SetBatching(bool batching) noexcept
+{
+    if (m_batching && !batching)
+    {
+        Flush();
+    }
+
+    m_batching = batching;
+}
+
+bool b2DrawRayLib::IsBatching() const noexcept
+{
+    return m_batching;
+}
+
+void b2DrawRayLib::Flush() noexcept
+{
+    m_stats.triangles += static_cast<int>(m_triangles.size() / 3);
+    m_stats.segments += static_cast<int>(m_lines.size() / 2);
+    m_stats.vertices += static_cast<int>(m_triangles.size() + m_lines.size());
+
+    M_Submit(RL_TRIANGLES, m_triangles);
+    M_Submit(RL_LINES, m_lines);
+
+    // clear() keeps the capacity, so steady-state frames never allocate
+    m_triangles.clear();
+    m_lines.clear();
+}
+
+b2DrawRayLib::Stats const& b2DrawRayLib::GetStats() const noexcept
+{
+    return m_stats;
+}
+
+void b2DrawRayLib::ResetStats() noexcept
+{
+    m_stats = {};
+}
+
+void b2DrawRayLib::M_Submit(int mode, std::vector<Vertex> const& vertices) noexcept
+{
+    for (size_t start = 0; start < vertices.size(); start += kChunkVertices)
+    {
+        auto const end = std::min(vertices.size(), start + kChunkVertices);
+
+        rlCheckRenderBatchLimit(static_cast<int>(end - start));
+        rlBegin(mode);
+        for (size_t i = start; i < end; ++i)
+        {
+            auto const& v = vertices[i];
+            rlColor4ub(v.color.r, v.color.g, v.color.b, v.color.a);
+            rlVertex2f(v.x, v.y);
+        }
+        rlEnd();
+
+        ++m_stats.drawCalls;
+    }
+}
+
 void b2DrawRayLib::DrawPolygon(b2Vec2 const* vertices, int32 vertexCount, b2Color const& color) noexcept
 {
     auto const count = static_cast<size_t>(vertexCount);
 
+    if (m_batching)
+    {
+        auto const c = M_ConvertColor(color);
+        for (size_t i = 0; i < count; ++i)
+        {
+            auto const a = M_ToPixels(vertices[i]);
+            auto const b = M_ToPixels(vertices[(i + 1) % count]);
+            m_lines.push_back({ a.x, a.y, c });
+            m_lines.push_back({ b.x, b.y, c });
+        }
+        return;
+    }
+
     for (size_t i = 0; i < count - 1; ++i)
     {
         DrawSegment(vertices[i], vertices[i + 1], color);
@@ -44,33 +172,89 @@ void b2DrawRayLib::DrawPolygon(b2Vec2 const* vertices, int32 vertexCount, b2Colo
 
 void b2DrawRayLib::DrawSolidPolygon(b2Vec2 const* vertices, int32 vertexCount, b2Color const& color) noexcept
 {
-    auto const count = static_cast<size_t>(vertexCount);
+    auto const count = std::min(static_cast<size_t>(vertexCount), static_cast<size_t>(b2_maxPolygonVertices));
 
-    auto convertedVertices = std::vector<Vector2>{ count };
+    // reversed so the winding survives the flip into screen space
+    Vector2 convertedVertices[b2_maxPolygonVertices];
 
     for (size_t i = 0; i < count; ++i)
     {
         convertedVertices[i] = M_ToPixels(vertices[count - i - 1]);
     }
 
-    DrawTriangleFan(convertedVertices.data(), count, M_ConvertColor(color, 0.8f));
+    auto const c = M_ConvertColor(color, 0.8f);
+
+    if (m_batching)
+    {
+        for (size_t i = 1; i + 1 < count; ++i)
+        {
+            m_triangles.push_back({ convertedVertices[0].x, convertedVertices[0].y, c });
+            m_triangles.push_back({ convertedVertices[i].x, convertedVertices[i].y, c });
+            m_triangles.push_back({ convertedVertices[i + 1].x, convertedVertices[i + 1].y, c });
+        }
+        return;
+    }
+
+    DrawTriangleFan(convertedVertices, count, c);
+    M_CountImmediate(count, count - 2, 0);
 }
 
 void b2DrawRayLib::DrawCircle(b2Vec2 const& center, float radius, b2Color const& color) noexcept
 {
     auto const convertedCenter = M_ToPixels(center);
 
+    if (m_batching)
+    {
+        auto const r = M_ToPixels(radius);
+        auto const c = M_ConvertColor(color);
+        for (int i = 0; i < kCircleSegments; ++i)
+        {
+            m_lines.push_back({ convertedCenter.x + r * unitCircle.x[i], convertedCenter.y + r * unitCircle.y[i], c });
+            m_lines.push_back({ convertedCenter.x + r * unitCircle.x[i + 1], convertedCenter.y + r * unitCircle.y[i + 1], c });
+        }
+        return;
+    }
+
     DrawCircleLines(convertedCenter.x, convertedCenter.y, M_ToPixels(radius), M_ConvertColor(color));
+    M_CountImmediate(2 * kCircleSegments, 0, kCircleSegments);
 }
 
 void b2DrawRayLib::DrawSolidCircle(b2Vec2 const& center, float radius, b2Vec2 const& /* axis */, b2Color const& color) noexcept
 {
+    if (m_batching)
+    {
+        auto const p = M_ToPixels(center);
+        auto const r = M_ToPixels(radius);
+        auto const c = M_ConvertColor(color, 0.8f);
+        for (int i = 0; i < kCircleSegments; ++i)
+        {
+            // same winding as raylib's DrawCircleSector
+            m_triangles.push_back({ p.x, p.y, c });
+            m_triangles.push_back({ p.x + r * unitCircle.x[i + 1], p.y + r * unitCircle.y[i + 1], c });
+            m_triangles.push_back({ p.x + r * unitCircle.x[i], p.y + r * unitCircle.y[i], c });
+        }
+        return;
+    }
+
     DrawCircleV(M_ToPixels(center), M_ToPixels(radius), M_ConvertColor(color, 0.8f));
+    M_CountImmediate(3 * kCircleSegments, kCircleSegments, 0);
 }
 
 void b2DrawRayLib::DrawSegment(b2Vec2 const& p1, b2Vec2 const& p2, b2Color const& color) noexcept
 {
-    DrawLineV(M_ToPixels(p1), M_ToPixels(p2), M_ConvertColor(color));
+    auto const a = M_ToPixels(p1);
+    auto const b = M_ToPixels(p2);
+    auto const c = M_ConvertColor(color);
+
+    if (m_batching)
+    {
+        m_lines.push_back({ a.x, a.y, c });
+        m_lines.push_back({ b.x, b.y, c });
+        return;
+    }
+
+    DrawLineV(a, b, c);
+    M_CountImmediate(2, 0, 1);
 }
 
 void b2DrawRayLib::DrawTransform(b2Transform const& xf) noexcept
@@ -86,6 +270,14 @@ void b2DrawRayLib::DrawPoint(b2Vec2 const& p, float size, b2Color const& color)
     DrawSolidCircle(p, size, {}, color);
 }
 
+void b2DrawRayLib::M_CountImmediate(size_t vertices, size_t triangles, size_t segments) noexcept
+{
+    ++m_stats.drawCalls;
+    m_stats.vertices += static_cast<int>(vertices);
+    m_stats.triangles += static_cast<int>(triangles);
+    m_stats.segments += static_cast<int>(segments);
+}
+
 float b2DrawRayLib::M_ToPixels(float f) const noexcept
 {
     return f * m_scale;
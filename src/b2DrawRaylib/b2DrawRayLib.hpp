@@ -4,13 +4,27 @@
 #include <raylib.h>
 
 // Box2D
+#include <box2d/b2_collision.h>
 #include <box2d/b2_draw.h>
 
+// C++
+#include <vector>
+
 ///
 class b2DrawRayLib : public b2Draw
 {
 public:
 
+    /// Work done since the last ResetStats(), by every Flush() in batching
+    /// mode and every Draw* call in immediate mode.
+    struct Stats
+    {
+        int drawCalls = 0; ///< rlBegin/rlEnd runs handed to rlgl
+        int vertices = 0;
+        int triangles = 0;
+        int segments = 0;
+    };
+
     ///
     explicit b2DrawRayLib(float scale = 1.0f) noexcept;
 
@@ -23,6 +37,28 @@ public:
     ///
     float GetScale() noexcept;
 
+    /// The part of the world, in meters, that is on a screen of the given
+    /// size when drawing inside BeginMode2D(camera). Anything outside it
+    /// can be skipped.
+    b2AABB GetVisibleAABB(Camera2D const& camera, float screenWidth, float screenHeight) const noexcept;
+
+    /// When on, Draw* calls only record geometry into reusable buffers and
+    /// nothing reaches rlgl until Flush().
+    void SetBatching(bool batching) noexcept;
+
+    ///
+    bool IsBatching() const noexcept;
+
+    /// Submits everything recorded since the last flush, triangles first
+    /// and then lines, in as few rlgl batches as its buffer allows.
+    void Flush() noexcept;
+
+    ///
+    Stats const& GetStats() const noexcept;
+
+    ///
+    void ResetStats() noexcept;
+
     ///
     void DrawPolygon(b2Vec2 const* vertices, int32 vertexCount, b2Color const& color) noexcept;
 
@@ -46,6 +82,18 @@ public:
 
 private:
 
+    struct Vertex
+    {
+        float x, y;
+        Color color;
+    };
+
+    /// PRIV:
+    void M_Submit(int mode, std::vector<Vertex> const& vertices) noexcept;
+
+    /// PRIV:
+    void M_CountImmediate(size_t vertices, size_t triangles, size_t segments) noexcept;
+
     /// PRIV:
     float M_ToPixels(float f) const noexcept;
 
@@ -59,4 +107,9 @@ private:
     Color M_ConvertColor(b2Color const& color, float newAlpha) const noexcept;
 
     float m_scale;
+
+    bool m_batching = false;
+    std::vector<Vertex> m_triangles;
+    std::vector<Vertex> m_lines;
+    Stats m_stats;
 };
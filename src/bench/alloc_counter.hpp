@@ -0,0 +1,10 @@
+#pragma once
+
+#include <cstdint>
+
+// Counts heap allocations made anywhere in the process, including inside
+// the prebuilt Box2D library. On glibc this interposes malloc itself; on
+// other platforms only operator new is seen, which misses Box2D's b2Alloc,
+// so the JSON says which one was used.
+uint64_t allocationCount();
+char const* allocationCounterKind();
@@ -0,0 +1,212 @@
+// robosim_bench: steps the canonical field scenes with no window and prints
+// per-step timing and allocation counts as JSON, so two builds (or two
+// machines) can be compared by diffing the output.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include <box2d/box2d.h>
+
+#include "alloc_counter.hpp"
+#include "robosim/scenes.hpp"
+
+struct BenchOptions {
+	int physicsHz = 200;
+	int steps = 2000;
+	int warmup = 200;
+	uint32_t seed = 2175;
+	char const* scene = nullptr;
+	char const* outPath = nullptr;
+};
+
+static void printUsage(char const* prog) {
+	fprintf(stderr,
+		"usage: %s [options]\n"
+		"  --hz <rate>      physics rate (default 200)\n"
+		"  --steps <n>      timed steps per scene (default 2000)\n"
+		"  --warmup <n>     untimed steps before timing starts (default 200)\n"
+		"  --seed <n>       seed for game piece placement (default 2175)\n"
+		"  --scene <text>   only run scenes whose name contains text\n"
+		"  --out <path>     write JSON here instead of stdout\n",
+		prog
+	);
+}
+
+static bool parseBenchOptions(int argc, char** argv, BenchOptions& opts) {
+	for (int i = 1; i < argc; i++) {
+		char const* arg = argv[i];
+		char const* next = i + 1 < argc ? argv[i + 1] : nullptr;
+
+		if (strcmp(arg, "--hz") == 0 && next) {
+			opts.physicsHz = atoi(next);
+			i++;
+		} else if (strcmp(arg, "--steps") == 0 && next) {
+			opts.steps = atoi(next);
+			i++;
+		} else if (strcmp(arg, "--warmup") == 0 && next) {
+			opts.warmup = atoi(next);
+			i++;
+		} else if (strcmp(arg, "--seed") == 0 && next) {
+			opts.seed = strtoul(next, nullptr, 0);
+			i++;
+		} else if (strcmp(arg, "--scene") == 0 && next) {
+			opts.scene = next;
+			i++;
+		} else if (strcmp(arg, "--out") == 0 && next) {
+			opts.outPath = next;
+			i++;
+		} else {
+			printUsage(argv[0]);
+			return false;
+		}
+	}
+
+	if (opts.physicsHz <= 0 || opts.steps <= 0 || opts.warmup < 0) {
+		fprintf(stderr, "--hz and --steps must be positive\n");
+		return false;
+	}
+	return true;
+}
+
+struct SceneResult {
+	char const* name;
+	int bodies;
+	double contacts;
+	double wall;
+	double stepsPerSec;
+	// step times in ms
+	double mean;
+	double p50;
+	double p90;
+	double p99;
+	double max;
+	double allocsPerStep;
+	uint64_t allocs;
+};
+
+static double percentile(std::vector<double> const& sorted, double p) {
+	size_t i = static_cast<size_t>(p * (sorted.size() - 1) + 0.5);
+	return sorted[i];
+}
+
+static SceneResult runScene(SceneSpec const& spec, BenchOptions const& opts) {
+	using clock = std::chrono::steady_clock;
+
+	Scene scene = buildScene(spec, opts.seed);
+	b2World& world = *scene.world;
+	float timeStep = 1.0f / opts.physicsHz;
+
+	int step = 0;
+	for (; step < opts.warmup; step++) {
+		driveScene(scene, step * static_cast<double>(timeStep));
+		world.Step(timeStep, 6, 2);
+	}
+
+	// reserved up front so the only allocations counted are the sim's
+	std::vector<double> times(opts.steps);
+	long contacts = 0;
+
+	uint64_t allocsBefore = allocationCount();
+	auto start = clock::now();
+	for (int i = 0; i < opts.steps; i++, step++) {
+		driveScene(scene, step * static_cast<double>(timeStep));
+		auto t0 = clock::now();
+		world.Step(timeStep, 6, 2);
+		auto t1 = clock::now();
+		times[i] = std::chrono::duration<double, std::milli>(t1 - t0).count();
+		contacts += world.GetContactCount();
+	}
+	auto end = clock::now();
+	uint64_t allocs = allocationCount() - allocsBefore;
+
+	SceneResult r{};
+	r.name = spec.name;
+	r.bodies = world.GetBodyCount();
+	r.contacts = static_cast<double>(contacts) / opts.steps;
+	r.wall = std::chrono::duration<double>(end - start).count();
+	r.stepsPerSec = r.wall > 0 ? opts.steps / r.wall : 0;
+
+	double sum = 0;
+	for (double t : times) {
+		sum += t;
+	}
+	r.mean = sum / opts.steps;
+	std::sort(times.begin(), times.end());
+	r.p50 = percentile(times, 0.50);
+	r.p90 = percentile(times, 0.90);
+	r.p99 = percentile(times, 0.99);
+	r.max = times.back();
+	r.allocs = allocs;
+	r.allocsPerStep = static_cast<double>(allocs) / opts.steps;
+	return r;
+}
+
+static void writeJson(FILE* out, BenchOptions const& opts, std::vector<SceneResult> const& results) {
+	fprintf(out, "{\n");
+	fprintf(out, "  \"box2d\": \"%d.%d.%d\",\n", b2_version.major, b2_version.minor, b2_version.revision);
+	fprintf(out, "  \"physics_hz\": %d,\n", opts.physicsHz);
+	fprintf(out, "  \"steps\": %d,\n", opts.steps);
+	fprintf(out, "  \"warmup\": %d,\n", opts.warmup);
+	fprintf(out, "  \"seed\": %u,\n", opts.seed);
+	fprintf(out, "  \"alloc_counter\": \"%s\",\n", allocationCounterKind());
+	fprintf(out, "  \"scenes\": [\n");
+	for (size_t i = 0; i < results.size(); i++) {
+		SceneResult const& r = results[i];
+		fprintf(out, "    {\n");
+		fprintf(out, "      \"name\": \"%s\",\n", r.name);
+		fprintf(out, "      \"bodies\": %d,\n", r.bodies);
+		fprintf(out, "      \"avg_contacts\": %.1f,\n", r.contacts);
+		fprintf(out, "      \"wall_s\": %.6f,\n", r.wall);
+		fprintf(out, "      \"steps_per_sec\": %.1f,\n", r.stepsPerSec);
+		fprintf(out, "      \"realtime_factor\": %.2f,\n", r.stepsPerSec / opts.physicsHz);
+		fprintf(out, "      \"step_ms\": {\"mean\": %.6f, \"p50\": %.6f, \"p90\": %.6f, \"p99\": %.6f, \"max\": %.6f},\n",
+			r.mean, r.p50, r.p90, r.p99, r.max);
+		fprintf(out, "      \"allocs\": %llu,\n", static_cast<unsigned long long>(r.allocs));
+		fprintf(out, "      \"allocs_per_step\": %.3f\n", r.allocsPerStep);
+		fprintf(out, "    }%s\n", i + 1 < results.size() ? "," : "");
+	}
+	fprintf(out, "  ]\n");
+	fprintf(out, "}\n");
+}
+
+int main(int argc, char** argv) {
+	BenchOptions opts;
+	if (!parseBenchOptions(argc, argv, opts)) {
+		return 1;
+	}
+
+	std::vector<SceneResult> results;
+	for (int i = 0; i < kBenchSceneCount; i++) {
+		SceneSpec const& spec = kBenchScenes[i];
+		if (opts.scene && !strstr(spec.name, opts.scene)) {
+			continue;
+		}
+		SceneResult r = runScene(spec, opts);
+		// progress on stderr so stdout stays valid JSON
+		fprintf(stderr, "%-36s %9.0f steps/s  p99 %.3f ms  %.2f allocs/step\n",
+			r.name, r.stepsPerSec, r.p99, r.allocsPerStep);
+		results.push_back(r);
+	}
+	if (results.empty()) {
+		fprintf(stderr, "no scene matches '%s'\n", opts.scene);
+		return 1;
+	}
+
+	FILE* out = stdout;
+	if (opts.outPath) {
+		out = fopen(opts.outPath, "w");
+		if (!out) {
+			fprintf(stderr, "couldn't open %s for writing\n", opts.outPath);
+			return 1;
+		}
+	}
+	writeJson(out, opts, results);
+	if (out != stdout) {
+		fclose(out);
+	}
+	return 0;
+}
@@ -37,7 +37,10 @@
 #include <GLFW/glfw3.h>
 #endif
 
+#include <algorithm>
 #include <math.h>
+#include <stddef.h>
+#include <string.h>
 #include <vector>
 #include <map>
 
@@ -48,6 +51,18 @@
 static std::vector<Texture> LoadedTextures;
 static Texture2D FontTexture;
 
+#if defined(GRAPHICS_API_OPENGL_11)
+// rlgl has no vertex or index buffers on OpenGL 1.1
+static bool UseIndexedRendering = false;
+#else
+static bool UseIndexedRendering = true;
+#endif
+static unsigned int IndexedVao = 0;
+static unsigned int IndexedVbo = 0;
+static unsigned int IndexedEbo = 0;
+static int IndexedVboSize = 0;
+static int IndexedEboSize = 0;
+
 static ImGuiMouseCursor CurrentMouseCursor = ImGuiMouseCursor_COUNT;
 static std::map<ImGuiMouseCursor, MouseCursor> MouseCursorMap;
 
@@ -314,6 +329,154 @@ static void EnableScissor(float x, float y, float width, float height)
     rlScissor((int)x * io.DisplayFramebufferScale.x, (GetScreenHeight() - (int)(y + height)) * io.DisplayFramebufferScale.y, (int)width * io.DisplayFramebufferScale.x, (int)height * io.DisplayFramebufferScale.y);
 }
 
+// same product as raymath's MatrixMultiply, without pulling raymath into this file
+static Matrix rlImGuiMatrixMultiply(Matrix left, Matrix right)
+{
+    float a[16] = { left.m0, left.m1, left.m2, left.m3, left.m4, left.m5, left.m6, left.m7, left.m8, left.m9, left.m10, left.m11, left.m12, left.m13, left.m14, left.m15 };
+    float b[16] = { right.m0, right.m1, right.m2, right.m3, right.m4, right.m5, right.m6, right.m7, right.m8, right.m9, right.m10, right.m11, right.m12, right.m13, right.m14, right.m15 };
+    float c[16];
+    for (int i = 0; i < 4; ++i)
+        for (int j = 0; j < 4; ++j)
+            c[4 * i + j] = a[4 * i] * b[j] + a[4 * i + 1] * b[4 + j] + a[4 * i + 2] * b[8 + j] + a[4 * i + 3] * b[12 + j];
+
+    // Matrix declares its fields in m0, m4, m8, m12, m1, ... order
+    return Matrix{ c[0], c[4], c[8], c[12], c[1], c[5], c[9], c[13], c[2], c[6], c[10], c[14], c[3], c[7], c[11], c[15] };
+}
+
+// grows the persistent buffers to fit, doubling so a busy frame doesn't reallocate every time it gets a bit busier;
+// false if rlgl couldn't make them
+static bool rlImGuiReserveIndexedBuffers(int vertexBytes, int indexBytes)
+{
+    if (IndexedVao == 0)
+        IndexedVao = rlLoadVertexArray();
+
+    rlEnableVertexArray(IndexedVao);
+
+    if (vertexBytes > IndexedVboSize)
+    {
+        if (IndexedVbo != 0)
+            rlUnloadVertexBuffer(IndexedVbo);
+
+        IndexedVboSize = IndexedVboSize == 0 ? 64 * 1024 : IndexedVboSize;
+        while (IndexedVboSize < vertexBytes)
+            IndexedVboSize *= 2;
+
+        IndexedVbo = rlLoadVertexBuffer(nullptr, IndexedVboSize, true);
+    }
+
+    if (indexBytes > IndexedEboSize)
+    {
+        if (IndexedEbo != 0)
+            rlUnloadVertexBuffer(IndexedEbo);
+
+        IndexedEboSize = IndexedEboSize == 0 ? 32 * 1024 : IndexedEboSize;
+        while (IndexedEboSize < indexBytes)
+            IndexedEboSize *= 2;
+
+        IndexedEbo = rlLoadVertexBufferElement(nullptr, IndexedEboSize, true);
+    }
+
+    return IndexedVbo != 0 && IndexedEbo != 0;
+}
+
+static void rlImGuiUnloadIndexedBuffers()
+{
+    if (IndexedVbo != 0)
+        rlUnloadVertexBuffer(IndexedVbo);
+    if (IndexedEbo != 0)
+        rlUnloadVertexBuffer(IndexedEbo);
+    if (IndexedVao != 0)
+        rlUnloadVertexArray(IndexedVao);
+
+    IndexedVao = IndexedVbo = IndexedEbo = 0;
+    IndexedVboSize = IndexedEboSize = 0;
+}
+
+// false, having drawn nothing, if the buffers can't be had
+static bool rlRenderDataIndexed(ImDrawData* data)
+{
+    // sized for the biggest list before anything is drawn, so a failed load can still fall back cleanly
+    int maxVertexBytes = 0;
+    int maxIndexBytes = 0;
+    for (int l = 0; l < data->CmdListsCount; ++l)
+    {
+        maxVertexBytes = std::max(maxVertexBytes, data->CmdLists[l]->VtxBuffer.Size * (int)sizeof(ImDrawVert));
+        maxIndexBytes = std::max(maxIndexBytes, data->CmdLists[l]->IdxBuffer.Size * (int)sizeof(ImDrawIdx));
+    }
+    if (maxVertexBytes == 0 || maxIndexBytes == 0)
+        return true;
+
+    if (!rlImGuiReserveIndexedBuffers(maxVertexBytes, maxIndexBytes))
+    {
+        rlDisableVertexArray();
+        rlImGuiUnloadIndexedBuffers();
+        return false;
+    }
+
+    rlDrawRenderBatchActive();
+    rlDisableBackfaceCulling();
+
+    // draw with raylib's own default shader, set up the way rlDrawRenderBatch would
+    unsigned int shader = rlGetShaderIdDefault();
+    int* locs = rlGetShaderLocsDefault();
+    rlEnableShader(shader);
+    rlSetUniformMatrix(locs[RL_SHADER_LOC_MATRIX_MVP], rlImGuiMatrixMultiply(rlGetMatrixModelview(), rlGetMatrixProjection()));
+    float white[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+    rlSetUniform(locs[RL_SHADER_LOC_COLOR_DIFFUSE], white, RL_SHADER_UNIFORM_VEC4, 1);
+    int slot = 0;
+    rlSetUniform(locs[RL_SHADER_LOC_MAP_DIFFUSE], &slot, RL_SHADER_UNIFORM_INT, 1);
+    rlActiveTextureSlot(0);
+
+    for (int l = 0; l < data->CmdListsCount; ++l)
+    {
+        const ImDrawList* commandList = data->CmdLists[l];
+
+        int vertexBytes = commandList->VtxBuffer.Size * (int)sizeof(ImDrawVert);
+        int indexBytes = commandList->IdxBuffer.Size * (int)sizeof(ImDrawIdx);
+        if (vertexBytes == 0 || indexBytes == 0)
+            continue;
+
+        // one upload per list; every command below draws out of it
+        rlUpdateVertexBuffer(IndexedVbo, commandList->VtxBuffer.Data, vertexBytes, 0);
+        rlEnableVertexBufferElement(IndexedEbo);
+        rlUpdateVertexBufferElements(IndexedEbo, commandList->IdxBuffer.Data, indexBytes, 0);
+
+        // attribute pointers are re-set every list so this also works where VAOs aren't available
+        rlEnableVertexBuffer(IndexedVbo);
+        rlSetVertexAttribute(locs[RL_SHADER_LOC_VERTEX_POSITION], 2, RL_FLOAT, false, sizeof(ImDrawVert), (void*)offsetof(ImDrawVert, pos));
+        rlEnableVertexAttribute(locs[RL_SHADER_LOC_VERTEX_POSITION]);
+        rlSetVertexAttribute(locs[RL_SHADER_LOC_VERTEX_TEXCOORD01], 2, RL_FLOAT, false, sizeof(ImDrawVert), (void*)offsetof(ImDrawVert, uv));
+        rlEnableVertexAttribute(locs[RL_SHADER_LOC_VERTEX_TEXCOORD01]);
+        rlSetVertexAttribute(locs[RL_SHADER_LOC_VERTEX_COLOR], 4, RL_UNSIGNED_BYTE, true, sizeof(ImDrawVert), (void*)offsetof(ImDrawVert, col));
+        rlEnableVertexAttribute(locs[RL_SHADER_LOC_VERTEX_COLOR]);
+
+        for (const auto& cmd : commandList->CmdBuffer)
+        {
+            EnableScissor(cmd.ClipRect.x - data->DisplayPos.x, cmd.ClipRect.y - data->DisplayPos.y, cmd.ClipRect.z - (cmd.ClipRect.x - data->DisplayPos.x), cmd.ClipRect.w - (cmd.ClipRect.y - data->DisplayPos.y));
+            if (cmd.UserCallback != nullptr)
+            {
+                cmd.UserCallback(commandList, &cmd);
+
+                continue;
+            }
+
+            Texture* texture = (Texture*)cmd.TextureId;
+            rlEnableTexture(texture == nullptr ? rlGetTextureIdDefault() : texture->id);
+            rlDrawVertexArrayElements((int)cmd.IdxOffset, (int)cmd.ElemCount, 0);
+        }
+    }
+
+    rlDisableVertexArray();
+    rlDisableVertexBuffer();
+    rlDisableVertexBufferElement();
+    rlDisableTexture();
+    rlDisableShader();
+
+    rlDisableScissorTest();
+    rlEnableBackfaceCulling();
+    return true;
+}
+
 static void rlRenderData(ImDrawData* data)
 {
     rlDrawRenderBatchActive();
@@ -457,11 +620,29 @@ void rlImGuiBegin()
 void rlImGuiEnd()
 {
     ImGui::Render();
-    rlRenderData(ImGui::GetDrawData());
+
+    // no vertex buffers from rlgl (OpenGL 1.1, or out of memory) means the immediate path from here on
+    if (UseIndexedRendering && !rlRenderDataIndexed(ImGui::GetDrawData()))
+        UseIndexedRendering = false;
+
+    if (!UseIndexedRendering)
+        rlRenderData(ImGui::GetDrawData());
+}
+
+void rlImGuiSetIndexedRendering(bool enabled)
+{
+    UseIndexedRendering = enabled;
+}
+
+bool rlImGuiIsIndexedRendering()
+{
+    return UseIndexedRendering;
 }
 
 void rlImGuiShutdown()
 {
+    rlImGuiUnloadIndexedBuffers();
+
     for (const auto& tx : LoadedTextures)
         UnloadTexture(tx);
 
@@ -47,6 +47,12 @@ void rlImGuiBegin();
 void rlImGuiEnd();
 void rlImGuiShutdown();
 
+// render path: indexed (default) uploads each ImDrawList into a persistent VBO/EBO and issues one
+// indexed draw per command, immediate feeds every vertex through rlgl's batch. Indexed is off on
+// OpenGL 1.1 builds, and switches itself off if rlgl can't make the buffers.
+void rlImGuiSetIndexedRendering(bool enabled);
+bool rlImGuiIsIndexedRendering();
+
 // Advanced StartupAPI
 void rlImGuiBeginInitImGui();
 void rlImGuiEndInitImGui();
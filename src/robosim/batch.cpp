@@ -0,0 +1,153 @@
+#include "batch.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "determinism.hpp"
+#include "drivetrain.hpp"
+#include "rng.hpp"
+#include "sim.hpp"
+#include "stats.hpp"
+
+struct RunResult {
+	float err;
+	float maxErr;
+};
+
+uint32_t runSeed(uint32_t base, int run) {
+	// philox doubles as a good integer hash
+	return philox({static_cast<uint32_t>(run), 0, 0, 0}, {base, 0x5eed})[0];
+}
+
+static RunResult runOne(Options const& opts, int run, InputScript const& script, HashTrace& trace) {
+	auto sim = std::make_unique<Sim>(opts.physicsHz, runSeed(opts.seed, run));
+	TankDrivetrain drivetrain;
+	if (opts.drivetrain) {
+		sim->attachDrivetrain(drivetrain);
+	}
+	while (sim->time() < opts.seconds) {
+		if (!script.empty()) {
+			sim->input = script.at(sim->time());
+		}
+		sim->step();
+		if (opts.deterministic) {
+			trace.update(*sim);
+		}
+	}
+	return {sim->err(), sim->maxErr};
+}
+
+int runBatch(Options const& opts) {
+	int threads = opts.threads;
+	if (threads == 0) {
+		threads = std::max(1u, std::thread::hardware_concurrency());
+	}
+	threads = std::min(threads, opts.batch);
+
+	InputScript script;
+	if (opts.inputPath && !script.load(opts.inputPath)) {
+		return 1;
+	}
+
+	GoldenFile golden;
+	if (opts.goldenPath && (!golden.open(opts.goldenPath) || !golden.matches(opts.physicsHz, opts.seed, opts.seconds, opts.batch))) {
+		return 1;
+	}
+
+	std::vector<RunResult> results(opts.batch);
+	std::vector<HashTrace> traces(opts.deterministic ? opts.batch : 0);
+	for (int i = 0; i < static_cast<int>(traces.size()); i++) {
+		setupTrace(traces[i], opts, runSeed(opts.seed, i), opts.goldenPath ? &golden : nullptr, i);
+	}
+	HashTrace unused;
+	std::atomic<int> next{0};
+
+	auto start = std::chrono::steady_clock::now();
+
+	// runs are long and roughly equal, so workers just grab the next index
+	std::vector<std::thread> workers;
+	for (int t = 0; t < threads; t++) {
+		workers.emplace_back([&] {
+			for (int i = next++; i < opts.batch; i = next++) {
+				results[i] = runOne(opts, i, script, opts.deterministic ? traces[i] : unused);
+			}
+		});
+	}
+	for (auto& w : workers) {
+		w.join();
+	}
+
+	auto end = std::chrono::steady_clock::now();
+	double wall = std::chrono::duration<double>(end - start).count();
+
+	std::vector<float> errs, maxErrs;
+	int worst = 0;
+	for (int i = 0; i < opts.batch; i++) {
+		errs.push_back(results[i].err);
+		maxErrs.push_back(results[i].maxErr);
+		if (results[i].maxErr > results[worst].maxErr) {
+			worst = i;
+		}
+	}
+	Stats errStats = computeStats(errs);
+	Stats maxErrStats = computeStats(maxErrs);
+
+	double simSeconds = static_cast<double>(opts.seconds) * opts.batch;
+	printf("%d runs of %.2f s on %d threads in %.3f s wall (base seed %u)\n", opts.batch, opts.seconds, threads, wall, opts.seed);
+	printf("sim-seconds per wall-second: %.1f\n", wall > 0 ? simSeconds / wall : 0.0);
+	printf("%-10s %14s %14s %14s\n", "", "mean", "p95", "max");
+	printf("%-10s %14f %14f %14f\n", "Err", errStats.mean, errStats.p95, errStats.max);
+	printf("%-10s %14f %14f %14f\n", "Max Err", maxErrStats.mean, maxErrStats.p95, maxErrStats.max);
+	printf("worst run: #%d (--seed %u)\n", worst, runSeed(opts.seed, worst));
+
+	if (!opts.deterministic) {
+		return 0;
+	}
+
+	// one hash for the whole batch, so two batches compare at a glance
+	uint64_t batchHash = 0;
+	for (HashTrace const& t : traces) {
+		batchHash = batchHash * 0x100000001b3ull ^ t.rolling;
+	}
+	printf("batch state hash: %016llx\n", static_cast<unsigned long long>(batchHash));
+
+	if (opts.recordGoldenPath) {
+		GoldenHeader header{};
+		header.physicsHz = opts.physicsHz;
+		header.seed = opts.seed;
+		header.stride = traces.empty() ? opts.hashStride : traces[0].stride;
+		header.seconds = opts.seconds;
+		std::vector<HashTrace const*> runs;
+		for (HashTrace const& t : traces) {
+			runs.push_back(&t);
+		}
+		if (!writeGolden(opts.recordGoldenPath, header, runs)) {
+			return 1;
+		}
+		printf("wrote golden trace %s (%d runs)\n", opts.recordGoldenPath, opts.batch);
+	}
+
+	if (opts.goldenPath) {
+		int diverged = 0;
+		for (int i = 0; i < opts.batch; i++) {
+			if (traces[i].divergedAt >= 0 || !traces[i].complete()) {
+				char label[64];
+				snprintf(label, sizeof(label), "run #%d (--seed %u)", i, traces[i].seed);
+				printDivergence(traces[i], opts.physicsHz, label);
+				diverged++;
+			}
+		}
+		if (diverged > 0) {
+			printf("%d of %d runs diverged from golden trace %s\n", diverged, opts.batch, opts.goldenPath);
+			return 2;
+		}
+		printf("all %d runs match golden trace %s\n", opts.batch, opts.goldenPath);
+	}
+
+	return 0;
+}
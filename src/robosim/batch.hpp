@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstdint>
+
+#include "options.hpp"
+
+// runs opts.batch independent headless sims (own world, bot and noise
+// stream each) across a pool of threads, then prints error statistics
+int runBatch(Options const& opts);
+
+// each run's seed only depends on the base seed and its index, so any
+// single run can be reproduced with --headless --seed
+uint32_t runSeed(uint32_t base, int run);
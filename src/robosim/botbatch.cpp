@@ -0,0 +1,107 @@
+#include "botbatch.hpp"
+
+#include "simd.hpp"
+
+void BotBatch::resize(size_t n) {
+	angle.resize(n);
+	vel.resize(n);
+	posX.resize(n);
+	posY.resize(n);
+}
+
+Bot BotBatch::get(size_t i) const {
+	return {angle[i], vel[i], {posX[i], posY[i]}, nullptr};
+}
+
+void BotBatch::set(size_t i, Bot const& bot) {
+	angle[i] = bot.angle;
+	vel[i] = bot.vel;
+	posX[i] = bot.pos.x;
+	posY[i] = bot.pos.y;
+}
+
+static void integrateScalar(float* angle, float* vel, float* posX, float* posY, size_t begin, size_t end, float damping, float k) {
+	for (size_t i = begin; i < end; i++) {
+		integrateBot(angle[i], vel[i], posX[i], posY[i], damping, k);
+	}
+}
+
+#ifdef ROBOSIM_AVX2
+
+// sin and cos of x in radians, cephes-style: reduce by the nearest multiple
+// of pi/2 in three parts, then pick and sign the minimax polynomials by
+// quadrant. The reduction is only accurate for |x| up to a few thousand,
+// so callers wrap x first.
+AVX2_FN static void sincos8(__m256 x, __m256* s, __m256* c) {
+	__m256 j = _mm256_round_ps(_mm256_mul_ps(x, _mm256_set1_ps(0.636619772f)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+	__m256 r = _mm256_fnmadd_ps(j, _mm256_set1_ps(1.5703125f), x);
+	r = _mm256_fnmadd_ps(j, _mm256_set1_ps(4.837512969970703125e-4f), r);
+	r = _mm256_fnmadd_ps(j, _mm256_set1_ps(7.54978995489188216e-8f), r);
+	__m256 r2 = _mm256_mul_ps(r, r);
+
+	__m256 sp = _mm256_fmadd_ps(r2, _mm256_set1_ps(-1.9515295891e-4f), _mm256_set1_ps(8.3321608736e-3f));
+	sp = _mm256_fmadd_ps(sp, r2, _mm256_set1_ps(-1.6666654611e-1f));
+	sp = _mm256_fmadd_ps(_mm256_mul_ps(sp, r2), r, r);
+
+	__m256 cp = _mm256_fmadd_ps(r2, _mm256_set1_ps(2.443315711809948e-5f), _mm256_set1_ps(-1.388731625493765e-3f));
+	cp = _mm256_fmadd_ps(cp, r2, _mm256_set1_ps(4.166664568298827e-2f));
+	cp = _mm256_mul_ps(_mm256_mul_ps(cp, r2), r2);
+	cp = _mm256_add_ps(_mm256_fnmadd_ps(_mm256_set1_ps(0.5f), r2, _mm256_set1_ps(1.0f)), cp);
+
+	__m256i q = _mm256_cvtps_epi32(j);
+	__m256i one = _mm256_set1_epi32(1);
+	__m256i two = _mm256_set1_epi32(2);
+
+	// odd quadrants swap sin and cos; bit 1 of the quadrant (of q + 1 for
+	// cos) flips the sign
+	__m256 swap = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(q, one), one));
+	__m256 sinSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(q, two), 30));
+	__m256 cosSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(_mm256_add_epi32(q, one), two), 30));
+
+	*s = _mm256_xor_ps(_mm256_blendv_ps(sp, cp, swap), sinSign);
+	*c = _mm256_xor_ps(_mm256_blendv_ps(cp, sp, swap), cosSign);
+}
+
+AVX2_FN static void integrateAvx2(float* angle, float* vel, float* posX, float* posY, size_t n, float damping, float k) {
+	__m256 vdamping = _mm256_set1_ps(damping);
+	__m256 vk = _mm256_set1_ps(k);
+	__m256 deg2rad = _mm256_set1_ps(DEG2RAD);
+	__m256 turn = _mm256_set1_ps(360.0f);
+	__m256 perTurn = _mm256_set1_ps(1 / 360.0f);
+
+	size_t i = 0;
+	for (; i + 8 <= n; i += 8) {
+		__m256 v = _mm256_mul_ps(_mm256_loadu_ps(vel + i), vdamping);
+		_mm256_storeu_ps(vel + i, v);
+
+		// wrapped to [-180, 180] like integrateBot's remainderf; the fma
+		// makes the subtraction exact
+		__m256 a = _mm256_loadu_ps(angle + i);
+		__m256 turns = _mm256_round_ps(_mm256_mul_ps(a, perTurn), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+		a = _mm256_fnmadd_ps(turns, turn, a);
+
+		__m256 s, c;
+		sincos8(_mm256_mul_ps(a, deg2rad), &s, &c);
+
+		__m256 step = _mm256_mul_ps(vk, v);
+		_mm256_storeu_ps(posX + i, _mm256_fmadd_ps(step, c, _mm256_loadu_ps(posX + i)));
+		_mm256_storeu_ps(posY + i, _mm256_fmadd_ps(step, s, _mm256_loadu_ps(posY + i)));
+	}
+
+	integrateScalar(angle, vel, posX, posY, i, n, damping, k);
+}
+
+#endif
+
+void BotBatch::integrate(float damping, float k, bool simd) {
+#ifdef ROBOSIM_AVX2
+	static bool const avx2 = haveAvx2();
+	if (simd && avx2) {
+		integrateAvx2(angle.data(), vel.data(), posX.data(), posY.data(), size(), damping, k);
+		return;
+	}
+#else
+	(void)simd;
+#endif
+	integrateScalar(angle.data(), vel.data(), posX.data(), posY.data(), 0, size(), damping, k);
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "sim.hpp"
+
+// Many bots laid out as structure-of-arrays, so the kinematics step can
+// run eight bots per instruction instead of one.
+struct BotBatch {
+	std::vector<float> angle;
+	std::vector<float> vel;
+	std::vector<float> posX;
+	std::vector<float> posY;
+
+	size_t size() const { return angle.size(); }
+	void resize(size_t n);
+
+	// the returned bot has no noise source attached
+	Bot get(size_t i) const;
+	void set(size_t i, Bot const& bot);
+
+	// integrateBot() for every bot. With simd off (or no AVX2 on this CPU)
+	// this is bit-identical to stepping each bot through Sim; the AVX2 path
+	// uses polynomial sin/cos and agrees to within a few ulp.
+	void integrate(float damping, float k, bool simd = true);
+};
@@ -0,0 +1,239 @@
+#include "determinism.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#include "drivetrain.hpp"
+
+bool InputScript::load(char const* path) {
+	FILE* f = fopen(path, "r");
+	if (!f) {
+		fprintf(stderr, "can't open input script %s\n", path);
+		return false;
+	}
+
+	events.clear();
+	char line[256];
+	int lineNo = 0;
+	bool ok = true;
+	while (fgets(line, sizeof(line), f)) {
+		lineNo++;
+		char* hash = strchr(line, '#');
+		if (hash) {
+			*hash = '\0';
+		}
+
+		char* tok = strtok(line, " \t\r\n");
+		if (!tok) {
+			continue;
+		}
+		char* end;
+		Event e{strtod(tok, &end), {}};
+		if (*end != '\0' || e.t < 0) {
+			fprintf(stderr, "%s:%d: expected a time in seconds, got '%s'\n", path, lineNo, tok);
+			ok = false;
+			break;
+		}
+		while ((tok = strtok(nullptr, " \t\r\n"))) {
+			if (strcmp(tok, "left") == 0) {
+				e.input.left = true;
+			} else if (strcmp(tok, "right") == 0) {
+				e.input.right = true;
+			} else if (strcmp(tok, "up") == 0) {
+				e.input.up = true;
+			} else if (strcmp(tok, "down") == 0) {
+				e.input.down = true;
+			} else if (strcmp(tok, "none") != 0) {
+				fprintf(stderr, "%s:%d: unknown button '%s'\n", path, lineNo, tok);
+				ok = false;
+				break;
+			}
+		}
+		if (!ok) {
+			break;
+		}
+		if (!events.empty() && e.t < events.back().t) {
+			fprintf(stderr, "%s:%d: times must not go backwards\n", path, lineNo);
+			ok = false;
+			break;
+		}
+		events.push_back(e);
+	}
+	fclose(f);
+	return ok;
+}
+
+DriverInput InputScript::at(double t) const {
+	auto it = std::upper_bound(events.begin(), events.end(), t, [](double t, Event const& e) { return t < e.t; });
+	if (it == events.begin()) {
+		return {};
+	}
+	return std::prev(it)->input;
+}
+
+static inline uint64_t mix(uint64_t h, uint64_t v) {
+	h ^= v;
+	h *= 0xff51afd7ed558ccdull;
+	h ^= h >> 33;
+	return h;
+}
+
+static inline uint64_t bits(float a, float b) {
+	uint32_t x, y;
+	memcpy(&x, &a, sizeof(x));
+	memcpy(&y, &b, sizeof(y));
+	return static_cast<uint64_t>(x) << 32 | y;
+}
+
+uint64_t hashState(Sim const& sim) {
+	uint64_t h = mix(0x9e3779b97f4a7c15ull, static_cast<uint64_t>(sim.tick));
+	h = mix(h, bits(sim.bot.angle, sim.bot.vel));
+	h = mix(h, bits(sim.bot.pos.x, sim.bot.pos.y));
+
+	for (b2Body const* b = sim.world.GetBodyList(); b; b = b->GetNext()) {
+		b2Vec2 p = b->GetPosition();
+		b2Vec2 v = b->GetLinearVelocity();
+		h = mix(h, bits(p.x, p.y));
+		h = mix(h, bits(b->GetAngle(), b->GetAngularVelocity()));
+		h = mix(h, bits(v.x, v.y));
+		h = mix(h, b->IsAwake() | b->IsEnabled() << 1);
+	}
+
+	// the sag carries into the next tick's motor voltage
+	if (sim.drivetrain) {
+		h = mix(h, bits(sim.drivetrain->state.busVoltage, sim.drivetrain->state.batteryCurrent));
+	}
+	return h;
+}
+
+void HashTrace::update(Sim const& sim) {
+	rolling = mix(rolling, hashState(sim));
+	if (sim.tick % stride != 0) {
+		return;
+	}
+
+	if (recording) {
+		hashes.push_back(rolling);
+	}
+
+	if (expected && divergedAt < 0 && checked < expectedCount) {
+		if (expected[checked] != rolling) {
+			divergedAt = sim.tick;
+			expectedHash = expected[checked];
+			actualHash = rolling;
+		}
+		checked++;
+	}
+}
+
+// each run in the file: its seed, a reserved word, the hash count, then
+// the hashes
+struct GoldenRunHeader {
+	uint32_t seed;
+	uint32_t reserved;
+	uint64_t count;
+};
+
+bool writeGolden(char const* path, GoldenHeader header, std::vector<HashTrace const*> const& runs) {
+	FILE* f = fopen(path, "wb");
+	if (!f) {
+		fprintf(stderr, "can't open %s for writing\n", path);
+		return false;
+	}
+	header.magic = kGoldenMagic;
+	header.version = kGoldenVersion;
+	header.runs = static_cast<uint32_t>(runs.size());
+	bool ok = fwrite(&header, sizeof(header), 1, f) == 1;
+	for (HashTrace const* run : runs) {
+		GoldenRunHeader rh{run->seed, 0, run->hashes.size()};
+		ok = ok && fwrite(&rh, sizeof(rh), 1, f) == 1;
+		ok = ok && fwrite(run->hashes.data(), sizeof(uint64_t), run->hashes.size(), f) == run->hashes.size();
+	}
+	ok = fclose(f) == 0 && ok;
+	if (!ok) {
+		fprintf(stderr, "error writing %s\n", path);
+	}
+	return ok;
+}
+
+bool GoldenFile::open(char const* path) {
+	if (!file.open(path)) {
+		return false;
+	}
+	if (file.size() < sizeof(GoldenHeader)) {
+		fprintf(stderr, "%s is too short to be a golden trace\n", path);
+		return false;
+	}
+	memcpy(&head, file.data(), sizeof(head));
+	if (head.magic != kGoldenMagic || head.version != kGoldenVersion) {
+		fprintf(stderr, "%s isn't a version %u golden trace\n", path, kGoldenVersion);
+		return false;
+	}
+
+	offsets.clear();
+	counts.clear();
+	size_t at = sizeof(GoldenHeader);
+	for (uint32_t i = 0; i < head.runs; i++) {
+		GoldenRunHeader rh;
+		if (at + sizeof(rh) > file.size()) {
+			fprintf(stderr, "%s is truncated\n", path);
+			return false;
+		}
+		memcpy(&rh, file.data() + at, sizeof(rh));
+		at += sizeof(rh);
+		if (rh.count > (file.size() - at) / sizeof(uint64_t)) {
+			fprintf(stderr, "%s is truncated\n", path);
+			return false;
+		}
+		offsets.push_back(at);
+		counts.push_back(rh.count);
+		at += rh.count * sizeof(uint64_t);
+	}
+	return true;
+}
+
+bool GoldenFile::matches(uint32_t physicsHz, uint32_t seed, float seconds, uint32_t runs) const {
+	if (head.physicsHz != physicsHz || head.seed != seed || head.seconds != seconds || head.runs != runs) {
+		fprintf(stderr, "golden trace was recorded with --hz %u --seed %u --seconds %g and %u run(s); rerun with those\n",
+			head.physicsHz, head.seed, head.seconds, head.runs);
+		return false;
+	}
+	return true;
+}
+
+uint64_t const* GoldenFile::run(uint32_t i, size_t& count) const {
+	count = counts[i];
+	// the header and run headers are all multiples of 8 bytes, so this
+	// stays aligned
+	return reinterpret_cast<uint64_t const*>(file.data() + offsets[i]);
+}
+
+void setupTrace(HashTrace& trace, Options const& opts, uint32_t seed, GoldenFile const* golden, uint32_t run) {
+	trace.seed = seed;
+	// hashes are only comparable at the stride they were recorded at
+	trace.stride = golden ? static_cast<int>(golden->header().stride) : opts.hashStride;
+	trace.recording = opts.recordGoldenPath != nullptr;
+	if (trace.recording) {
+		trace.hashes.reserve(static_cast<size_t>(opts.seconds * opts.physicsHz / trace.stride) + 1);
+	}
+	if (golden) {
+		trace.expected = golden->run(run, trace.expectedCount);
+	}
+}
+
+void printDivergence(HashTrace const& trace, int physicsHz, char const* label) {
+	if (trace.divergedAt < 0) {
+		if (!trace.complete()) {
+			printf("%s: matched golden for %zu of its %zu hashes, then ran out\n", label, trace.checked, trace.expectedCount);
+		}
+		return;
+	}
+	int64_t tick = trace.divergedAt;
+	if (trace.stride == 1) {
+		printf("%s: first diverged from golden at tick %lld (t = %.3f s)", label, static_cast<long long>(tick), tick / static_cast<double>(physicsHz));
+	} else {
+		printf("%s: first diverged from golden in ticks %lld..%lld", label, static_cast<long long>(tick - trace.stride + 1), static_cast<long long>(tick));
+	}
+	printf(": expected %016llx, got %016llx\n", static_cast<unsigned long long>(trace.expectedHash), static_cast<unsigned long long>(trace.actualHash));
+}
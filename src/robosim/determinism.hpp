@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "mapped_file.hpp"
+#include "options.hpp"
+#include "sim.hpp"
+
+// Deterministic-mode support: scripted driver input in place of the
+// keyboard, a cheap per-tick hash of the whole sim state, and golden traces
+// of those hashes to check later runs against.
+
+// A driver input script, one line per change:
+//
+//   # seconds  buttons held from then on (left right up down, or none)
+//   0.0  none
+//   2.5  up
+//   4.0  up left
+class InputScript {
+public:
+	// prints the reason and returns false on failure
+	bool load(char const* path);
+
+	// the buttons held at sim time t
+	DriverInput at(double t) const;
+
+	bool empty() const { return events.empty(); }
+
+private:
+	struct Event {
+		double t;
+		DriverInput input;
+	};
+	std::vector<Event> events;
+};
+
+// hash of everything that evolves: the tick, the bot, and every body's
+// pose, velocity and sleep state. Bit-exact, so -0.0 and 0.0 differ.
+uint64_t hashState(Sim const& sim);
+
+// Rolling hash over a run, recorded and/or checked against a golden run as
+// it goes. Every stride ticks the hash so far is kept, so a divergence is
+// pinned down to within stride ticks (exactly, at the default of 1).
+struct HashTrace {
+	uint32_t seed = 0;
+	int stride = 1;
+	uint64_t rolling = 0xcbf29ce484222325ull;
+
+	bool recording = false;
+	std::vector<uint64_t> hashes;
+
+	// golden hashes to compare with, if any
+	uint64_t const* expected = nullptr;
+	size_t expectedCount = 0;
+	size_t checked = 0;
+
+	// the first tick whose hash didn't match the golden run, or -1
+	int64_t divergedAt = -1;
+	uint64_t expectedHash = 0;
+	uint64_t actualHash = 0;
+
+	// call after every step
+	void update(Sim const& sim);
+
+	// false if the run ended without diverging but didn't cover the whole
+	// golden run
+	bool complete() const { return !expected || checked == expectedCount; }
+};
+
+// A file of hash traces, one per run (a single one for headless). The
+// header pins down everything else a rerun needs to match.
+struct GoldenHeader {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t physicsHz;
+	uint32_t seed;
+	uint32_t stride;
+	uint32_t runs;
+	float seconds;
+	uint32_t reserved;
+};
+
+constexpr uint32_t kGoldenMagic = 0x54475352; // "RSGT"
+constexpr uint32_t kGoldenVersion = 1;
+
+bool writeGolden(char const* path, GoldenHeader header, std::vector<HashTrace const*> const& runs);
+
+// Mapped golden file; run(i) points straight into the mapping.
+class GoldenFile {
+public:
+	// prints the reason and returns false on failure
+	bool open(char const* path);
+
+	GoldenHeader const& header() const { return head; }
+
+	// false (after printing why) if this file wasn't recorded with these
+	// settings, so comparing would be meaningless
+	bool matches(uint32_t physicsHz, uint32_t seed, float seconds, uint32_t runs) const;
+
+	uint64_t const* run(uint32_t i, size_t& count) const;
+
+private:
+	MappedFile file;
+	GoldenHeader head{};
+	std::vector<size_t> offsets;
+	std::vector<size_t> counts;
+};
+
+// sets trace up for one run of opts: stride, recording, and the matching
+// golden run if there is one
+void setupTrace(HashTrace& trace, Options const& opts, uint32_t seed, GoldenFile const* golden, uint32_t run);
+
+// one line on where trace left its golden run, if it did
+void printDivergence(HashTrace const& trace, int physicsHz, char const* label);
@@ -0,0 +1,106 @@
+#include "drivetrain.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+// heading and speed loops; duty per unit error
+constexpr float kSpeedP = 0.2f;     // per m/s
+constexpr float kHeadingP = 1.5f;   // per rad
+constexpr float kHeadingD = 0.15f;  // per rad/s
+
+constexpr float kGravity = 9.81f;
+
+TankDrivetrain::TankDrivetrain(TankConfig const& config) : config(config) {
+	state.busVoltage = config.battery.voltage;
+}
+
+b2Body* TankDrivetrain::create(b2World& world, b2Vec2 pos, float angle) {
+	b2BodyDef def;
+	def.type = b2_dynamicBody;
+	def.position = pos;
+	def.angle = angle;
+	// the tires do all the slowing down; no made-up damping
+	body = world.CreateBody(&def);
+
+	b2PolygonShape box;
+	box.SetAsBox(config.length / 2, config.length / 2);
+	b2FixtureDef fixture;
+	fixture.shape = &box;
+	fixture.density = config.mass / (config.length * config.length);
+	// bumper on bumper
+	fixture.friction = 0.3f;
+	fixture.restitution = 0.2f;
+	body->CreateFixture(&fixture);
+
+	state = {};
+	state.busVoltage = config.battery.voltage;
+	state.targetHeading = angle;
+	return body;
+}
+
+float TankDrivetrain::speed() const {
+	return b2Dot(body->GetLinearVelocity(), body->GetWorldVector({1, 0}));
+}
+
+float TankDrivetrain::sideForce(float duty, float wheelSpeed, float& current) const {
+	DcMotor const& m = config.motor;
+	float motorSpeed = wheelSpeed / config.wheelRadius * config.gearing;
+	float volts = duty * state.busVoltage;
+
+	// V = IR + w/kV, then the controller's current limit
+	current = (volts - motorSpeed / m.kV()) / m.resistance();
+	current = std::clamp(current, -config.currentLimit, config.currentLimit);
+
+	float torque = config.motorsPerSide * m.kT() * current * config.gearing * config.efficiency;
+	return torque / config.wheelRadius;
+}
+
+void TankDrivetrain::update(float dt) {
+	b2Vec2 forward = body->GetWorldVector({1, 0});
+	b2Vec2 lateral = body->GetWorldVector({0, 1});
+
+	// closed-loop speed and heading, feedforward on speed
+	float v = speed();
+	float omega = body->GetAngularVelocity();
+	float freeSpeed = config.motor.freeSpeed / config.gearing * config.wheelRadius;
+	float fwd = state.targetSpeed / freeSpeed + kSpeedP * (state.targetSpeed - v);
+	float turn = kHeadingP * (state.targetHeading - body->GetAngle()) - kHeadingD * omega;
+
+	// a side at local -y pushing forward turns the chassis toward +angle
+	float duty[2] = {fwd + turn, fwd - turn};
+	float biggest = std::max(std::abs(duty[0]), std::abs(duty[1]));
+	if (biggest > 1) {
+		duty[0] /= biggest;
+		duty[1] /= biggest;
+	}
+
+	// each wheel line carries half the robot
+	float grip = config.friction * config.mass * kGravity / 2;
+	float halfTrack = config.trackWidth / 2;
+	float batteryCurrent = 0;
+	for (int side = 0; side < 2; side++) {
+		b2Vec2 local{0, side == 0 ? -halfTrack : halfTrack};
+		b2Vec2 point = body->GetWorldPoint(local);
+		b2Vec2 vel = body->GetLinearVelocityFromWorldPoint(point);
+
+		float current;
+		float force = sideForce(duty[side], b2Dot(vel, forward), current);
+		force = std::clamp(force, -grip, grip);
+
+		// tires resist sliding sideways up to their grip: enough force to
+		// stop this line's share of the mass within the substep, no more
+		float scrub = -b2Dot(vel, lateral) * (config.mass / 2) / dt;
+		scrub = std::clamp(scrub, -grip, grip);
+
+		body->ApplyForce(force * forward + scrub * lateral, point, true);
+
+		state.motorCurrent[side] = current;
+		state.output[side] = duty[side];
+		// a controller at duty d draws d times its motor current
+		batteryCurrent += config.motorsPerSide * std::abs(current * duty[side]);
+	}
+
+	// the sag this draw causes is what the next substep sees
+	state.batteryCurrent = batteryCurrent;
+	state.busVoltage = std::max(0.0f, config.battery.voltage - batteryCurrent * config.battery.resistance);
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <box2d/box2d.h>
+
+// A brushed/brushless DC motor as its datasheet describes it, at 12 V.
+struct DcMotor {
+	float stallTorque;  // N*m
+	float stallCurrent; // A
+	float freeSpeed;    // rad/s
+	float freeCurrent;  // A
+
+	float resistance() const { return 12.0f / stallCurrent; }
+	float kT() const { return stallTorque / stallCurrent; }
+	// back-EMF constant, rad/s per volt
+	float kV() const { return freeSpeed / (12.0f - freeCurrent * resistance()); }
+};
+
+constexpr DcMotor kFalcon500{4.69f, 257.0f, 668.1f, 1.5f};
+constexpr DcMotor kNeo{2.6f, 105.0f, 594.4f, 1.8f};
+constexpr DcMotor kCim{2.41f, 131.0f, 558.5f, 2.7f};
+
+// A battery as an ideal source behind its internal (plus wiring)
+// resistance, so hard acceleration sags the voltage every motor sees.
+struct Battery {
+	float voltage = 12.6f;
+	float resistance = 0.02f;
+};
+
+struct TankConfig {
+	DcMotor motor = kFalcon500;
+	int motorsPerSide = 2;
+	float gearing = 8.45f;      // motor turns per wheel turn
+	float wheelRadius = 0.0762f; // m
+	float trackWidth = 0.56f;   // m, between the wheel lines
+	float length = 0.9f;        // m, bumper to bumper
+	float mass = 60.0f;         // kg, with battery and bumpers
+	float friction = 1.1f;      // wheel to carpet
+	float currentLimit = 60.0f; // A per motor
+	float efficiency = 0.9f;    // gearbox
+	Battery battery;
+};
+
+// Everything the drivetrain carries from one substep to the next, kept
+// separate so snapshots can save and restore it.
+struct DrivetrainState {
+	// what the robot program asked for: forward speed in m/s and heading in
+	// radians; held between robot loops
+	float targetSpeed = 0;
+	float targetHeading = 0;
+
+	// from the last substep: battery draw sets this substep's sag
+	float busVoltage = 12.6f;
+	float batteryCurrent = 0;
+	float motorCurrent[2] = {};
+	float output[2] = {};
+};
+
+// A differential (tank) drivetrain driving a real b2Body in a top-down,
+// gravity-free world. Each substep it turns the held speed and heading
+// targets into left/right duty cycles, runs them through the motor curves
+// at the sagged bus voltage, and applies the resulting wheel forces
+// (traction-limited) and lateral scrub friction at each wheel line. So
+// walls, game pieces and other robots push back for real.
+//
+// Meant to be updated at 1 kHz; update() does no allocation.
+class TankDrivetrain {
+public:
+	explicit TankDrivetrain(TankConfig const& config = {});
+
+	// makes the chassis body; pos in meters, angle in radians
+	b2Body* create(b2World& world, b2Vec2 pos, float angle);
+
+	// one substep of motor, battery and tire forces; call right before
+	// world.Step(dt)
+	void update(float dt);
+
+	// forward speed in m/s, as the chassis actually moves
+	float speed() const;
+
+	b2Body* body = nullptr;
+	TankConfig config;
+	DrivetrainState state;
+
+private:
+	// one side: its duty cycle in, force along the forward axis out
+	float sideForce(float duty, float wheelSpeed, float& current) const;
+};
@@ -0,0 +1,684 @@
+#include "field.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <utility>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+char const kFieldMagic[8] = {'R', 'S', 'F', 'I', 'E', 'L', 'D', '1'};
+uint32_t const kFieldVersion = 1;
+
+// Just enough JSON for field files: the whole document as a tree, with
+// the line each value started on for error messages.
+struct Json {
+	enum Type { kNull, kBool, kNumber, kString, kArray, kObject };
+
+	Type type = kNull;
+	int line = 0;
+	bool boolean = false;
+	double number = 0;
+	std::string string;
+	std::vector<Json> items;
+	std::vector<std::pair<std::string, Json>> members;
+
+	Json const* get(char const* key) const {
+		for (auto const& m : members) {
+			if (m.first == key) {
+				return &m.second;
+			}
+		}
+		return nullptr;
+	}
+};
+
+class JsonParser {
+public:
+	JsonParser(char const* path, std::string const& text) : path(path), p(text.c_str()) {}
+
+	bool parse(Json& out) {
+		if (!value(out)) {
+			return false;
+		}
+		skipSpace();
+		return *p == '\0' || fail("trailing characters after the document");
+	}
+
+private:
+	char const* path;
+	char const* p;
+	int line = 1;
+	int depth = 0;
+
+	bool fail(char const* what) {
+		fprintf(stderr, "%s:%d: %s\n", path, line, what);
+		return false;
+	}
+
+	void skipSpace() {
+		while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') {
+			line += *p == '\n';
+			p++;
+		}
+	}
+
+	bool literal(char const* word) {
+		size_t n = strlen(word);
+		if (strncmp(p, word, n) != 0) {
+			return false;
+		}
+		p += n;
+		return true;
+	}
+
+	bool string(std::string& out) {
+		p++; // opening quote
+		out.clear();
+		while (*p != '"') {
+			if (*p == '\0' || *p == '\n') {
+				return fail("unterminated string");
+			}
+			if (*p == '\\') {
+				p++;
+				switch (*p) {
+				case '"': case '\\': case '/': out += *p; break;
+				case 'n': out += '\n'; break;
+				case 't': out += '\t'; break;
+				default: return fail("unsupported escape in string");
+				}
+				p++;
+				continue;
+			}
+			out += *p++;
+		}
+		p++;
+		return true;
+	}
+
+	bool value(Json& out) {
+		skipSpace();
+		out.line = line;
+		if (++depth > 32) {
+			return fail("nested too deeply");
+		}
+
+		bool ok = true;
+		if (*p == '{') {
+			out.type = Json::kObject;
+			p++;
+			skipSpace();
+			if (*p == '}') {
+				p++;
+			} else {
+				while (ok) {
+					skipSpace();
+					if (*p != '"') {
+						ok = fail("expected a key");
+						break;
+					}
+					std::string key;
+					if (!string(key)) {
+						ok = false;
+						break;
+					}
+					skipSpace();
+					if (*p++ != ':') {
+						ok = fail("expected ':' after a key");
+						break;
+					}
+					out.members.emplace_back(std::move(key), Json{});
+					ok = value(out.members.back().second);
+					skipSpace();
+					if (ok && *p == '}') {
+						p++;
+						break;
+					}
+					if (ok && *p++ != ',') {
+						ok = fail("expected ',' or '}' in an object");
+					}
+				}
+			}
+		} else if (*p == '[') {
+			out.type = Json::kArray;
+			p++;
+			skipSpace();
+			if (*p == ']') {
+				p++;
+			} else {
+				while (ok) {
+					out.items.emplace_back();
+					ok = value(out.items.back());
+					skipSpace();
+					if (ok && *p == ']') {
+						p++;
+						break;
+					}
+					if (ok && *p++ != ',') {
+						ok = fail("expected ',' or ']' in an array");
+					}
+				}
+			}
+		} else if (*p == '"') {
+			out.type = Json::kString;
+			ok = string(out.string);
+		} else if (literal("true")) {
+			out.type = Json::kBool;
+			out.boolean = true;
+		} else if (literal("false")) {
+			out.type = Json::kBool;
+		} else if (literal("null")) {
+			out.type = Json::kNull;
+		} else {
+			char* end;
+			out.type = Json::kNumber;
+			out.number = strtod(p, &end);
+			if (end == p) {
+				ok = fail("expected a value");
+			}
+			p = end;
+		}
+
+		depth--;
+		return ok;
+	}
+};
+
+bool fail(char const* path, Json const& at, char const* what) {
+	fprintf(stderr, "%s:%d: %s\n", path, at.line, what);
+	return false;
+}
+
+bool getNumber(char const* path, Json const& obj, char const* key, float& out, bool required = true) {
+	Json const* v = obj.get(key);
+	if (!v) {
+		if (required) {
+			fprintf(stderr, "%s:%d: missing \"%s\"\n", path, obj.line, key);
+		}
+		return !required;
+	}
+	if (v->type != Json::kNumber || !std::isfinite(static_cast<float>(v->number))) {
+		fprintf(stderr, "%s:%d: \"%s\" must be a finite number\n", path, v->line, key);
+		return false;
+	}
+	out = static_cast<float>(v->number);
+	return true;
+}
+
+bool getPoints(char const* path, Json const& obj, std::vector<b2Vec2>& out) {
+	Json const* pts = obj.get("points");
+	if (!pts || pts->type != Json::kArray) {
+		return fail(path, obj, "expected \"points\": [[x, y], ...]");
+	}
+	for (Json const& pt : pts->items) {
+		if (pt.type != Json::kArray || pt.items.size() != 2
+			|| pt.items[0].type != Json::kNumber || pt.items[1].type != Json::kNumber) {
+			return fail(path, pt, "a point must be [x, y]");
+		}
+		if (!std::isfinite(static_cast<float>(pt.items[0].number)) || !std::isfinite(static_cast<float>(pt.items[1].number))) {
+			return fail(path, pt, "a point's coordinates must be finite");
+		}
+		out.push_back({static_cast<float>(pt.items[0].number), static_cast<float>(pt.items[1].number)});
+	}
+	return true;
+}
+
+// the array under key, or an empty one if it's not there
+Json const& getArray(Json const& obj, char const* key) {
+	static Json const empty = [] {
+		Json j;
+		j.type = Json::kArray;
+		return j;
+	}();
+	Json const* v = obj.get(key);
+	return v && v->type == Json::kArray ? *v : empty;
+}
+
+// whether b2PolygonShape::Set can make a polygon of these: it welds
+// points closer than half a slop, gift wraps the rest, and needs a hull of
+// at least 3 points with some area. Otherwise it asserts, or in release
+// quietly makes a 2 x 2 m box at the origin instead.
+bool solidHull(std::vector<b2Vec2> const& points) {
+	std::vector<b2Vec2> ps;
+	for (b2Vec2 v : points) {
+		bool unique = true;
+		for (b2Vec2 p : ps) {
+			if (b2DistanceSquared(v, p) < 0.25f * b2_linearSlop * b2_linearSlop) {
+				unique = false;
+				break;
+			}
+		}
+		if (unique) {
+			ps.push_back(v);
+		}
+	}
+	int n = static_cast<int>(ps.size());
+	if (n < 3) {
+		return false;
+	}
+
+	int i0 = 0;
+	for (int i = 1; i < n; i++) {
+		if (ps[i].x > ps[i0].x || (ps[i].x == ps[i0].x && ps[i].y < ps[i0].y)) {
+			i0 = i;
+		}
+	}
+	std::vector<int> hull;
+	for (int ih = i0;;) {
+		hull.push_back(ih);
+		int ie = 0;
+		for (int j = 1; j < n; j++) {
+			if (ie == ih) {
+				ie = j;
+				continue;
+			}
+			b2Vec2 r = ps[ie] - ps[ih];
+			b2Vec2 v = ps[j] - ps[ih];
+			float c = b2Cross(r, v);
+			if (c < 0 || (c == 0 && v.LengthSquared() > r.LengthSquared())) {
+				ie = j;
+			}
+		}
+		ih = ie;
+		if (ie == i0 || static_cast<int>(hull.size()) > n) {
+			break;
+		}
+	}
+	if (hull.size() < 3) {
+		return false;
+	}
+
+	float area = 0;
+	for (size_t i = 0; i < hull.size(); i++) {
+		area += b2Cross(ps[hull[i]], ps[hull[(i + 1) % hull.size()]]);
+	}
+	return std::abs(area) / 2 > b2_epsilon;
+}
+
+// the ghost vertex past `end`, continuing the segment from `before`
+b2Vec2 extend(b2Vec2 before, b2Vec2 end) {
+	return end + (end - before);
+}
+
+}
+
+bool parseField(char const* path, FieldSource& out) {
+	FILE* f = fopen(path, "rb");
+	if (!f) {
+		fprintf(stderr, "can't open field %s\n", path);
+		return false;
+	}
+	std::string text;
+	char buf[4096];
+	size_t n;
+	while ((n = fread(buf, 1, sizeof(buf), f)) > 0) {
+		text.append(buf, n);
+	}
+	fclose(f);
+
+	Json doc;
+	if (!JsonParser(path, text).parse(doc)) {
+		return false;
+	}
+	if (doc.type != Json::kObject) {
+		return fail(path, doc, "a field is a JSON object");
+	}
+
+	out = {};
+	if (Json const* name = doc.get("name"); name && name->type == Json::kString) {
+		out.name = name->string;
+	}
+	if (!getNumber(path, doc, "length", out.length) || !getNumber(path, doc, "width", out.width)) {
+		return false;
+	}
+	if (out.length <= 0 || out.width <= 0) {
+		return fail(path, doc, "length and width must be positive");
+	}
+
+	for (Json const& w : getArray(doc, "walls").items) {
+		FieldSource::Chain chain;
+		if (!getPoints(path, w, chain.points)) {
+			return false;
+		}
+		Json const* loop = w.get("loop");
+		chain.loop = loop && loop->type == Json::kBool && loop->boolean;
+		if (chain.points.size() < (chain.loop ? 3u : 2u)) {
+			return fail(path, w, "a wall needs at least 2 points, or 3 for a loop");
+		}
+		for (size_t i = 1; i < chain.points.size(); i++) {
+			if (b2DistanceSquared(chain.points[i - 1], chain.points[i]) <= b2_linearSlop * b2_linearSlop) {
+				return fail(path, w, "wall points are too close together");
+			}
+		}
+		if (chain.loop && b2DistanceSquared(chain.points.front(), chain.points.back()) <= b2_linearSlop * b2_linearSlop) {
+			return fail(path, w, "a loop closes itself; don't repeat the first point at the end");
+		}
+		out.walls.push_back(std::move(chain));
+	}
+
+	for (Json const& e : getArray(doc, "elements").items) {
+		std::vector<b2Vec2> points;
+		if (!getPoints(path, e, points)) {
+			return false;
+		}
+		if (points.size() < 3 || points.size() > b2_maxPolygonVertices) {
+			return fail(path, e, "an element needs 3 to 8 points");
+		}
+		if (!solidHull(points)) {
+			return fail(path, e, "an element's points are repeated or all in a line");
+		}
+		out.elements.push_back(std::move(points));
+	}
+
+	for (Json const& t : getArray(doc, "tags").items) {
+		FieldSource::Tag tag{};
+		float id = 0;
+		if (!getNumber(path, t, "id", id) || !getNumber(path, t, "x", tag.x) || !getNumber(path, t, "y", tag.y)
+			|| !getNumber(path, t, "z", tag.z, false) || !getNumber(path, t, "yaw", tag.yaw)) {
+			return false;
+		}
+		tag.id = static_cast<int>(id);
+		out.tags.push_back(tag);
+	}
+
+	for (Json const& z : getArray(doc, "zones").items) {
+		FieldSource::Zone zone;
+		if (Json const* name = z.get("name"); name && name->type == Json::kString) {
+			zone.name = name->string;
+		}
+		if (Json const* a = z.get("alliance"); a && a->type == Json::kString) {
+			if (a->string == "blue") {
+				zone.alliance = 0;
+			} else if (a->string == "red") {
+				zone.alliance = 1;
+			} else {
+				return fail(path, *a, "alliance must be \"blue\" or \"red\"");
+			}
+		}
+		Json const* scoring = z.get("scoring");
+		zone.scoring = scoring && scoring->type == Json::kBool && scoring->boolean;
+		if (!getPoints(path, z, zone.points)) {
+			return false;
+		}
+		if (zone.points.size() < 3) {
+			return fail(path, z, "a zone needs at least 3 points");
+		}
+		out.zones.push_back(std::move(zone));
+	}
+	return true;
+}
+
+FieldSource chargedUpField() {
+	FieldSource f;
+	f.name = "2023 Charged Up";
+	f.length = 16.54f;
+	f.width = 8.21f;
+	f.walls.push_back({{{0, 0}, {f.length, 0}, {f.length, f.width}, {0, f.width}}, true});
+
+	// the charge stations, as obstacles
+	for (float cx : {3.9f, f.length - 3.9f}) {
+		f.elements.push_back({{cx - 0.97f, 1.53f}, {cx + 0.97f, 1.53f}, {cx + 0.97f, 3.97f}, {cx - 0.97f, 3.97f}});
+	}
+
+	// the red grid's tags face -x and the blue grid's +x; the substation
+	// tags sit higher
+	f.tags = {
+		{1, 15.513f, 1.072f, 0.463f, 180},
+		{2, 15.513f, 2.748f, 0.463f, 180},
+		{3, 15.513f, 4.424f, 0.463f, 180},
+		{4, 16.179f, 6.750f, 0.695f, 180},
+		{5, 0.362f, 6.750f, 0.695f, 0},
+		{6, 1.027f, 4.424f, 0.463f, 0},
+		{7, 1.027f, 2.748f, 0.463f, 0},
+		{8, 1.027f, 1.072f, 0.463f, 0},
+	};
+
+	f.zones.push_back({"blue grid", 0, true, {{0, 0}, {1.4f, 0}, {1.4f, f.width}, {0, f.width}}});
+	f.zones.push_back({"red grid", 1, true, {{f.length - 1.4f, 0}, {f.length, 0}, {f.length, f.width}, {f.length - 1.4f, f.width}}});
+	return f;
+}
+
+std::vector<unsigned char> compileField(FieldSource const& src) {
+	FieldHeader header{};
+	memcpy(header.magic, kFieldMagic, sizeof(header.magic));
+	header.version = kFieldVersion;
+	strncpy(header.name, src.name.c_str(), sizeof(header.name) - 1);
+	header.length = src.length;
+	header.width = src.width;
+
+	std::vector<FieldChain> chains;
+	std::vector<b2Vec2> chainVerts;
+	for (FieldSource::Chain const& c : src.walls) {
+		FieldChain fc{};
+		fc.first = static_cast<uint32_t>(chainVerts.size());
+		fc.count = static_cast<uint32_t>(c.points.size());
+		fc.loop = c.loop;
+		size_t n = c.points.size();
+		fc.prev = extend(c.points[1], c.points[0]);
+		fc.next = extend(c.points[n - 2], c.points[n - 1]);
+		chains.push_back(fc);
+		chainVerts.insert(chainVerts.end(), c.points.begin(), c.points.end());
+	}
+
+	// b2PolygonShape::Set does the hull, welding and normals once, here,
+	// and the cache keeps the result
+	std::vector<FieldPolygon> polygons;
+	for (std::vector<b2Vec2> const& e : src.elements) {
+		b2PolygonShape shape;
+		shape.Set(e.data(), static_cast<int32>(e.size()));
+		FieldPolygon fp{};
+		fp.centroid = shape.m_centroid;
+		fp.count = shape.m_count;
+		memcpy(fp.vertices, shape.m_vertices, sizeof(fp.vertices));
+		memcpy(fp.normals, shape.m_normals, sizeof(fp.normals));
+		shape.ComputeAABB(&fp.bounds, b2Transform{b2Vec2_zero, b2Rot(0)}, 0);
+		polygons.push_back(fp);
+	}
+
+	std::vector<FieldTag> tags;
+	for (FieldSource::Tag const& t : src.tags) {
+		tags.push_back({t.id, t.x, t.y, t.z, t.yaw * b2_pi / 180});
+	}
+
+	std::vector<FieldZone> zones;
+	std::vector<b2Vec2> zoneVerts;
+	for (FieldSource::Zone const& z : src.zones) {
+		FieldZone fz{};
+		strncpy(fz.name, z.name.c_str(), sizeof(fz.name) - 1);
+		fz.alliance = z.alliance;
+		fz.flags = z.scoring ? uint32_t(kZoneScoring) : 0u;
+		fz.first = static_cast<uint32_t>(zoneVerts.size());
+		fz.count = static_cast<uint32_t>(z.points.size());
+		zones.push_back(fz);
+		zoneVerts.insert(zoneVerts.end(), z.points.begin(), z.points.end());
+	}
+
+	header.chainCount = static_cast<uint32_t>(chains.size());
+	header.chainVertexCount = static_cast<uint32_t>(chainVerts.size());
+	header.polygonCount = static_cast<uint32_t>(polygons.size());
+	header.tagCount = static_cast<uint32_t>(tags.size());
+	header.zoneCount = static_cast<uint32_t>(zones.size());
+	header.zoneVertexCount = static_cast<uint32_t>(zoneVerts.size());
+
+	std::vector<unsigned char> blob;
+	auto append = [&](void const* p, size_t size) {
+		auto bytes = static_cast<unsigned char const*>(p);
+		blob.insert(blob.end(), bytes, bytes + size);
+	};
+	append(&header, sizeof(header));
+	append(chains.data(), chains.size() * sizeof(FieldChain));
+	append(chainVerts.data(), chainVerts.size() * sizeof(b2Vec2));
+	append(polygons.data(), polygons.size() * sizeof(FieldPolygon));
+	append(tags.data(), tags.size() * sizeof(FieldTag));
+	append(zones.data(), zones.size() * sizeof(FieldZone));
+	append(zoneVerts.data(), zoneVerts.size() * sizeof(b2Vec2));
+	return blob;
+}
+
+bool Field::attach(unsigned char const* data, size_t size, char const* what) {
+	header = nullptr;
+	if (size < sizeof(FieldHeader)) {
+		fprintf(stderr, "%s is too short to be a compiled field\n", what);
+		return false;
+	}
+	auto h = reinterpret_cast<FieldHeader const*>(data);
+	if (memcmp(h->magic, kFieldMagic, sizeof(kFieldMagic)) != 0 || h->version != kFieldVersion) {
+		fprintf(stderr, "%s isn't a version %u compiled field\n", what, kFieldVersion);
+		return false;
+	}
+
+	uint64_t expected = sizeof(FieldHeader)
+		+ uint64_t(h->chainCount) * sizeof(FieldChain)
+		+ uint64_t(h->chainVertexCount) * sizeof(b2Vec2)
+		+ uint64_t(h->polygonCount) * sizeof(FieldPolygon)
+		+ uint64_t(h->tagCount) * sizeof(FieldTag)
+		+ uint64_t(h->zoneCount) * sizeof(FieldZone)
+		+ uint64_t(h->zoneVertexCount) * sizeof(b2Vec2);
+	if (expected != size) {
+		fprintf(stderr, "%s is truncated or corrupt\n", what);
+		return false;
+	}
+
+	// every record is made of 4-byte fields, so these stay aligned
+	unsigned char const* at = data + sizeof(FieldHeader);
+	chainList = reinterpret_cast<FieldChain const*>(at);
+	at += h->chainCount * sizeof(FieldChain);
+	chainVerts = reinterpret_cast<b2Vec2 const*>(at);
+	at += h->chainVertexCount * sizeof(b2Vec2);
+	polygonList = reinterpret_cast<FieldPolygon const*>(at);
+	at += h->polygonCount * sizeof(FieldPolygon);
+	tagList = reinterpret_cast<FieldTag const*>(at);
+	at += h->tagCount * sizeof(FieldTag);
+	zoneList = reinterpret_cast<FieldZone const*>(at);
+	at += h->zoneCount * sizeof(FieldZone);
+	zoneVerts = reinterpret_cast<b2Vec2 const*>(at);
+
+	for (uint32_t i = 0; i < h->chainCount; i++) {
+		if (uint64_t(chainList[i].first) + chainList[i].count > h->chainVertexCount) {
+			fprintf(stderr, "%s has a wall out of range\n", what);
+			return false;
+		}
+		if (chainList[i].count < (chainList[i].loop ? 3u : 2u)) {
+			fprintf(stderr, "%s has a wall with too few points\n", what);
+			return false;
+		}
+	}
+	for (uint32_t i = 0; i < h->polygonCount; i++) {
+		if (polygonList[i].count < 3 || polygonList[i].count > b2_maxPolygonVertices) {
+			fprintf(stderr, "%s has an element with a bad vertex count\n", what);
+			return false;
+		}
+	}
+	for (uint32_t i = 0; i < h->zoneCount; i++) {
+		if (uint64_t(zoneList[i].first) + zoneList[i].count > h->zoneVertexCount) {
+			fprintf(stderr, "%s has a zone out of range\n", what);
+			return false;
+		}
+	}
+	header = h;
+	return true;
+}
+
+void Field::load(FieldSource const& src) {
+	file.close();
+	owned = compileField(src);
+	fromCache = false;
+	attach(owned.data(), owned.size(), src.name.c_str());
+}
+
+bool Field::load(char const* path) {
+	std::error_code ec;
+	uint64_t sourceSize = fs::file_size(path, ec);
+	int64_t sourceTime = ec ? 0 : fs::last_write_time(path, ec).time_since_epoch().count();
+	if (ec) {
+		fprintf(stderr, "can't read field %s: %s\n", path, ec.message().c_str());
+		return false;
+	}
+
+	std::string cachePath = std::string(path) + ".rsfield";
+	if (fs::exists(cachePath, ec)) {
+		// a stale cache is recompiled; so is a broken one, after saying so
+		if (file.open(cachePath.c_str()) && file.size() >= sizeof(FieldHeader)) {
+			auto h = reinterpret_cast<FieldHeader const*>(file.data());
+			if (h->sourceSize == sourceSize && h->sourceTime == sourceTime
+				&& attach(file.data(), file.size(), cachePath.c_str())) {
+				fromCache = true;
+				return true;
+			}
+		}
+		file.close();
+	}
+
+	FieldSource src;
+	if (!parseField(path, src)) {
+		return false;
+	}
+	owned = compileField(src);
+	fromCache = false;
+	FieldHeader* h = reinterpret_cast<FieldHeader*>(owned.data());
+	h->sourceSize = sourceSize;
+	h->sourceTime = sourceTime;
+
+	FILE* f = fopen(cachePath.c_str(), "wb");
+	bool written = f && fwrite(owned.data(), 1, owned.size(), f) == owned.size();
+	if (f) {
+		written = fclose(f) == 0 && written;
+	}
+	if (!written) {
+		fprintf(stderr, "warning: couldn't write field cache %s\n", cachePath.c_str());
+		fs::remove(cachePath, ec);
+	}
+	return attach(owned.data(), owned.size(), path);
+}
+
+bool Field::inZone(FieldZone const& z, b2Vec2 p) const {
+	// even-odd crossings
+	bool inside = false;
+	b2Vec2 const* v = zoneVerts + z.first;
+	for (uint32_t i = 0, j = z.count - 1; i < z.count; j = i++) {
+		if ((v[i].y > p.y) != (v[j].y > p.y)
+			&& p.x < v[j].x + (p.y - v[j].y) * (v[i].x - v[j].x) / (v[i].y - v[j].y)) {
+			inside = !inside;
+		}
+	}
+	return inside;
+}
+
+b2Body* Field::build(b2World& world, b2Filter const& walls, b2Filter const& elements) const {
+	b2BodyDef def;
+	b2Body* body = world.CreateBody(&def);
+
+	for (uint32_t i = 0; i < header->chainCount; i++) {
+		FieldChain const& c = chainList[i];
+		b2ChainShape chain;
+		if (c.loop) {
+			chain.CreateLoop(chainVerts + c.first, c.count);
+		} else {
+			chain.CreateChain(chainVerts + c.first, c.count, c.prev, c.next);
+		}
+		b2FixtureDef fixture;
+		fixture.shape = &chain;
+		fixture.filter = walls;
+		body->CreateFixture(&fixture);
+	}
+
+	for (uint32_t i = 0; i < header->polygonCount; i++) {
+		FieldPolygon const& p = polygonList[i];
+		// straight into the shape, skipping Set()'s hull
+		b2PolygonShape shape;
+		shape.m_centroid = p.centroid;
+		shape.m_count = p.count;
+		memcpy(shape.m_vertices, p.vertices, sizeof(p.vertices));
+		memcpy(shape.m_normals, p.normals, sizeof(p.normals));
+		b2FixtureDef fixture;
+		fixture.shape = &shape;
+		fixture.friction = 0.3f;
+		fixture.filter = elements;
+		body->CreateFixture(&fixture);
+	}
+	return body;
+}
@@ -0,0 +1,182 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <box2d/box2d.h>
+
+#include "mapped_file.hpp"
+
+// A field as it's written by hand (see fields/ at the top of the repo), in
+// meters with the blue alliance wall at x = 0. Fields are JSON:
+//
+//   {
+//     "name": "...", "length": 16.54, "width": 8.21,
+//     "walls":    [{"points": [[x, y], ...], "loop": true}],
+//     "elements": [{"points": [[x, y], ...]}],
+//     "tags":     [{"id": 1, "x": 15.51, "y": 1.07, "z": 0.46, "yaw": 180}],
+//     "zones":    [{"name": "...", "alliance": "blue", "scoring": true,
+//                   "points": [[x, y], ...]}]
+//   }
+//
+// Walls are chains (a loop or an open run of segments), elements are
+// solid convex obstacles of up to b2_maxPolygonVertices points in any
+// order, tag yaw is in degrees, and zones are polygons that don't collide.
+struct FieldSource {
+	struct Chain {
+		std::vector<b2Vec2> points;
+		bool loop = false;
+	};
+	struct Tag {
+		int id;
+		float x, y, z;
+		float yaw;
+	};
+	struct Zone {
+		std::string name;
+		int alliance = -1;
+		bool scoring = false;
+		std::vector<b2Vec2> points;
+	};
+
+	std::string name;
+	float length = 0;
+	float width = 0;
+	std::vector<Chain> walls;
+	std::vector<std::vector<b2Vec2>> elements;
+	std::vector<Tag> tags;
+	std::vector<Zone> zones;
+};
+
+// prints file:line and the problem, and returns false, on bad input
+bool parseField(char const* path, FieldSource& out);
+
+// The 2023 field the match was first written against, for when no field
+// file is given; fields/charged-up-2023.json is the same thing.
+FieldSource chargedUpField();
+
+// Everything below is the compiled form, which is also the cache file's
+// layout: a header and then each array back to back, in the order the
+// header counts them. All of it is ready to hand to Box2D as is.
+
+struct FieldChain {
+	uint32_t first; // into the chain vertices
+	uint32_t count;
+	uint32_t loop;
+	uint32_t reserved;
+	// ghost vertices for an open chain, so its ends meet walls smoothly
+	b2Vec2 prev;
+	b2Vec2 next;
+};
+static_assert(sizeof(FieldChain) == 32, "FieldChain is the on-disk format");
+
+// b2PolygonShape's own fields, hull and normals already worked out
+struct FieldPolygon {
+	b2Vec2 centroid;
+	b2Vec2 vertices[b2_maxPolygonVertices];
+	b2Vec2 normals[b2_maxPolygonVertices];
+	int32_t count;
+	uint32_t reserved;
+	b2AABB bounds;
+};
+static_assert(sizeof(FieldPolygon) == 160, "FieldPolygon is the on-disk format");
+
+struct FieldTag {
+	int32_t id;
+	float x, y, z;
+	float yaw; // radians
+};
+static_assert(sizeof(FieldTag) == 20, "FieldTag is the on-disk format");
+
+enum FieldZoneFlags : uint32_t {
+	kZoneScoring = 1 << 0,
+};
+
+struct FieldZone {
+	char name[24];
+	int32_t alliance; // -1 for neither
+	uint32_t flags;
+	uint32_t first; // into the zone vertices
+	uint32_t count;
+};
+static_assert(sizeof(FieldZone) == 40, "FieldZone is the on-disk format");
+
+struct FieldHeader {
+	char magic[8];
+	uint32_t version;
+	uint32_t reserved;
+
+	// the source this was compiled from, to tell when it's stale
+	uint64_t sourceSize;
+	int64_t sourceTime;
+
+	char name[32];
+	float length;
+	float width;
+
+	uint32_t chainCount;
+	uint32_t chainVertexCount;
+	uint32_t polygonCount;
+	uint32_t tagCount;
+	uint32_t zoneCount;
+	uint32_t zoneVertexCount;
+};
+static_assert(sizeof(FieldHeader) == 96, "FieldHeader is the on-disk format");
+
+// Compiles FieldSource into a flat blob.
+std::vector<unsigned char> compileField(FieldSource const& src);
+
+// A compiled field, either mapped from its cache or held in memory. The
+// first load of a field file parses and compiles it and writes the blob
+// next to it as <path>.rsfield; every later load just maps that, as long
+// as the source hasn't changed since.
+class Field {
+public:
+	Field() = default;
+	Field(Field const&) = delete;
+	Field& operator=(Field const&) = delete;
+
+	// prints the reason and returns false on failure; a cache that can't
+	// be written is only a warning
+	bool load(char const* path);
+
+	// compiled in memory, no cache
+	void load(FieldSource const& src);
+
+	char const* name() const { return header->name; }
+	float length() const { return header->length; }
+	float width() const { return header->width; }
+
+	// whether load(path) got to skip parsing
+	bool cached() const { return fromCache; }
+
+	FieldChain const* chains(uint32_t& count) const { count = header->chainCount; return chainList; }
+	b2Vec2 const* chainVertices() const { return chainVerts; }
+	FieldPolygon const* polygons(uint32_t& count) const { count = header->polygonCount; return polygonList; }
+	FieldTag const* tags(uint32_t& count) const { count = header->tagCount; return tagList; }
+	FieldZone const* zones(uint32_t& count) const { count = header->zoneCount; return zoneList; }
+	b2Vec2 const* zoneVertices() const { return zoneVerts; }
+
+	// whether p is inside zone z (any winding)
+	bool inZone(FieldZone const& z, b2Vec2 p) const;
+
+	// one static body with every wall and element on it, filtered as given
+	b2Body* build(b2World& world, b2Filter const& walls, b2Filter const& elements) const;
+
+private:
+	// checks the blob and points the arrays into it
+	bool attach(unsigned char const* data, size_t size, char const* what);
+
+	MappedFile file;
+	std::vector<unsigned char> owned;
+	bool fromCache = false;
+
+	FieldHeader const* header = nullptr;
+	FieldChain const* chainList = nullptr;
+	b2Vec2 const* chainVerts = nullptr;
+	FieldPolygon const* polygonList = nullptr;
+	FieldTag const* tagList = nullptr;
+	FieldZone const* zoneList = nullptr;
+	b2Vec2 const* zoneVerts = nullptr;
+};
@@ -0,0 +1,45 @@
+#include "game_pieces.hpp"
+
+#include "scenes.hpp"
+
+void GamePiecePool::reserve(b2World& world, int capacity, b2Filter const& filter) {
+	all.reserve(all.size() + capacity);
+	parked.reserve(all.capacity());
+	for (int i = 0; i < capacity; i++) {
+		b2Body* piece = addGamePiece(world, {0, 0}, {0, 0});
+		for (b2Fixture* f = piece->GetFixtureList(); f; f = f->GetNext()) {
+			f->SetFilterData(filter);
+		}
+		piece->SetEnabled(false);
+		all.push_back(piece);
+	}
+	// spawn in creation order, so a fresh pool hands pieces out the way
+	// creating them one by one would have
+	for (int i = 0; i < capacity; i++) {
+		parked.push_back(all[all.size() - 1 - i]);
+	}
+}
+
+b2Body* GamePiecePool::spawn(b2Vec2 pos, b2Vec2 vel) {
+	if (parked.empty()) {
+		return nullptr;
+	}
+	b2Body* piece = parked.back();
+	parked.pop_back();
+
+	// moved while disabled, so the broadphase proxy is made once, in place
+	piece->SetTransform(pos, 0);
+	piece->SetLinearVelocity(vel);
+	piece->SetAngularVelocity(0);
+	piece->SetAwake(true);
+	piece->SetEnabled(true);
+	return piece;
+}
+
+void GamePiecePool::despawn(b2Body* piece) {
+	if (!piece->IsEnabled()) {
+		return;
+	}
+	piece->SetEnabled(false);
+	parked.push_back(piece);
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <vector>
+
+#include <box2d/box2d.h>
+
+// A fixed set of game piece bodies, created once and recycled. Scoring
+// games put hundreds of pieces in and out of play every match, and going
+// through CreateBody/CreateFixture/DestroyBody each time churns Box2D's
+// block allocator and rebuilds broadphase proxies from scratch.
+//
+// A piece out of play is parked with SetEnabled(false): it keeps its body
+// and fixture but leaves the broadphase and the contact graph, so it costs
+// nothing per step. Spawning takes a parked piece, moves it, and enables
+// it again. Once the broadphase's tree and buffers have grown to the
+// largest number of pieces that were ever in play together, spawn() and
+// despawn() don't touch the heap at all.
+class GamePiecePool {
+public:
+	// creates capacity parked pieces with the given collision filter; the
+	// only place the pool creates bodies
+	void reserve(b2World& world, int capacity, b2Filter const& filter = {});
+
+	// puts a parked piece in play at pos, moving at vel. Returns nullptr
+	// when every piece is already in play.
+	b2Body* spawn(b2Vec2 pos, b2Vec2 vel = {0, 0});
+
+	// takes a piece out of play; does nothing if it's already parked
+	void despawn(b2Body* piece);
+
+	// every piece, in play or not, in creation order
+	std::vector<b2Body*> const& pieces() const { return all; }
+
+	int capacity() const { return static_cast<int>(all.size()); }
+	int active() const { return capacity() - static_cast<int>(parked.size()); }
+
+private:
+	std::vector<b2Body*> all;
+
+	// a stack, so the most recently parked piece (with its fixture still in
+	// cache) goes back out first
+	std::vector<b2Body*> parked;
+};
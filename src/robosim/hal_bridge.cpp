@@ -0,0 +1,140 @@
+#include "hal_bridge.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <new>
+
+#include "profiler.hpp"
+
+HalBridge::~HalBridge() {
+	close();
+}
+
+#ifdef _WIN32
+
+bool HalBridge::open(char const* n) {
+	fprintf(stderr, "--hal needs POSIX shared memory; not supported on Windows yet (%s)\n", n);
+	return false;
+}
+
+void HalBridge::close() {}
+
+#else
+
+bool HalBridge::open(char const* n) {
+	close();
+
+	// shm names are a single leading slash and nothing else
+	name = n[0] == '/' ? n : std::string("/") + n;
+
+	// a sim that crashed may have left one behind
+	shm_unlink(name.c_str());
+	int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+	if (fd < 0) {
+		perror("shm_open");
+		return false;
+	}
+	if (ftruncate(fd, sizeof(HalRegion)) != 0) {
+		perror("ftruncate");
+		::close(fd);
+		shm_unlink(name.c_str());
+		return false;
+	}
+	void* p = mmap(nullptr, sizeof(HalRegion), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	::close(fd);
+	if (p == MAP_FAILED) {
+		perror("mmap");
+		shm_unlink(name.c_str());
+		return false;
+	}
+
+	region = new (p) HalRegion{};
+	region->magic = kHalMagic;
+	region->version = kHalVersion;
+	printf("HAL bridge ready at %s\n", name.c_str());
+	return true;
+}
+
+void HalBridge::close() {
+	if (region) {
+		munmap(region, sizeof(HalRegion));
+		region = nullptr;
+		shm_unlink(name.c_str());
+	}
+}
+
+#endif
+
+bool HalBridge::attached() const {
+	return region && region->robotState.load(std::memory_order_acquire) == kHalRobotAttached;
+}
+
+bool HalBridge::waitForRobot(int ms) {
+	auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(ms);
+	while (!attached()) {
+		if (!region || std::chrono::steady_clock::now() > deadline) {
+			return false;
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	return true;
+}
+
+bool HalBridge::exchange(RobotLoopIo& io, int64_t tick, int64_t encoderCounts) {
+	if (!attached()) {
+		return false;
+	}
+	PROFILE_ZONE("HAL round trip");
+
+	HalSensors s;
+	s.tick = tick;
+	s.time = io.time;
+	s.gyroAngle = io.sensedAngle;
+	s.encoderRate = io.sensedVel;
+	s.encoderCounts = encoderCounts;
+	s.posX = io.sensedPosX;
+	s.posY = io.sensedPosY;
+	s.buttons = io.left | io.right << 1 | io.up << 2 | io.down << 3;
+	s.enabled = 1;
+
+	// at most one loop is ever in flight, so this only fails if the robot
+	// stopped reading, and then it's timed out below
+	uint64_t start = profilerNowNs();
+	region->sensors.push(s);
+
+	// spin, checking the clock only now and then
+	HalOutputs out;
+	uint32_t spins = 0;
+	uint64_t timeoutNs = static_cast<uint64_t>(timeoutMs) * 1000000;
+	for (;;) {
+		if (region->outputs.pop(out)) {
+			if (out.tick == tick) {
+				break;
+			}
+			// a late answer to a loop we already gave up on
+			continue;
+		}
+		halRelax(spins);
+		if (spins % 256 == 0) {
+			if (!attached()) {
+				return false;
+			}
+			if (profilerNowNs() - start > timeoutNs) {
+				fprintf(stderr, "HAL: robot didn't answer tick %lld within %d ms, detaching it\n", static_cast<long long>(tick), timeoutMs);
+				region->robotState.store(kHalRobotDetached, std::memory_order_release);
+				return false;
+			}
+		}
+	}
+
+	double us = (profilerNowNs() - start) / 1000.0;
+	roundTrips++;
+	meanRoundTripUs += (us - meanRoundTripUs) / roundTrips;
+	if (us > maxRoundTripUs) {
+		maxRoundTripUs = us;
+	}
+
+	io.angle += out.turn;
+	io.vel += out.accel;
+	return true;
+}
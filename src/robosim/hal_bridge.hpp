@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "hal_shm.hpp"
+#include "robot_abi.hpp"
+
+// drivetrain encoder resolution, in counts per pixel of travel
+constexpr double kHalCountsPerPixel = 10.0;
+
+// The sim's end of the shared-memory HAL. While a robot process is
+// attached, every robot loop hands it the sensors and blocks until its
+// outputs for that same tick come back; while none is, the bot just keeps
+// its last commands. A robot that stops answering is dropped after a
+// timeout instead of hanging the sim.
+class HalBridge {
+public:
+	~HalBridge();
+
+	// creates the region (replacing a stale one of the same name); POSIX only
+	bool open(char const* name);
+	void close();
+
+	bool attached() const;
+
+	// blocks until a robot attaches or timeoutMs passes
+	bool waitForRobot(int timeoutMs);
+
+	// one lockstep robot loop: io's sensor fields go out, and on success the
+	// robot's turn and accel are applied to its angle and vel
+	bool exchange(RobotLoopIo& io, int64_t tick, int64_t encoderCounts);
+
+	// how long a robot may take to answer before it's considered gone
+	int timeoutMs = 1000;
+
+	// round trips, sensors out to outputs back
+	uint64_t roundTrips = 0;
+	double meanRoundTripUs = 0;
+	double maxRoundTripUs = 0;
+
+private:
+	HalRegion* region = nullptr;
+	std::string name;
+};
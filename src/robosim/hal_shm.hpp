@@ -0,0 +1,190 @@
+#pragma once
+
+// The shared-memory layout between the sim and robot code running in its
+// own process, plus a small client for the robot side. Header-only and
+// free of raylib and Box2D, so external robot code only needs this file.
+//
+// The sim creates the region with shm_open; the robot opens it by name.
+// Each robot loop the sim pushes a HalSensors frame and waits for the
+// HalOutputs frame with the same tick, so the two run in lockstep in sim
+// time. Both directions are single-producer/single-consumer rings of plain
+// structs; nothing locks and nothing crosses the kernel once mapped.
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+constexpr uint32_t kHalMagic = 0x4c485352; // "RSHL"
+constexpr uint32_t kHalVersion = 1;
+
+// sim to robot, once per robot loop
+struct HalSensors {
+	int64_t tick;
+	double time;
+
+	// gyro heading in degrees, noise included
+	float gyroAngle;
+
+	// drivetrain encoder: rate (noisy, same units as the bot's velocity)
+	// and accumulated distance in counts
+	float encoderRate;
+	int64_t encoderCounts;
+
+	// field position, as a pose estimate would report it (noisy, pixels)
+	float posX;
+	float posY;
+
+	// driver station: bit 0 left, 1 right, 2 up, 3 down
+	uint32_t buttons;
+	uint32_t enabled;
+};
+
+// robot to sim: this loop's drivetrain command, as a change in heading
+// (degrees) and in speed, the same way the built-in program drives
+struct HalOutputs {
+	int64_t tick;
+	float turn;
+	float accel;
+};
+
+// A fixed-size ring that lives entirely inside the shared region, so it
+// holds no pointers. Indices only ever grow; N must be a power of two.
+template <typename T, uint32_t N>
+struct HalRing {
+	static_assert((N & (N - 1)) == 0, "ring size must be a power of two");
+
+	alignas(64) std::atomic<uint64_t> head;
+	alignas(64) std::atomic<uint64_t> tail;
+	alignas(64) T items[N];
+
+	bool push(T const& item) {
+		uint64_t h = head.load(std::memory_order_relaxed);
+		if (h - tail.load(std::memory_order_acquire) >= N) {
+			return false;
+		}
+		items[h & (N - 1)] = item;
+		head.store(h + 1, std::memory_order_release);
+		return true;
+	}
+
+	bool pop(T& item) {
+		uint64_t t = tail.load(std::memory_order_relaxed);
+		if (t == head.load(std::memory_order_acquire)) {
+			return false;
+		}
+		item = items[t & (N - 1)];
+		tail.store(t + 1, std::memory_order_release);
+		return true;
+	}
+};
+
+// the region shared between two processes only works if these never fall
+// back to a lock inside the process
+static_assert(std::atomic<uint64_t>::is_always_lock_free);
+static_assert(std::atomic<uint32_t>::is_always_lock_free);
+
+enum HalRobotState : uint32_t {
+	kHalRobotAbsent,
+	kHalRobotAttached,
+	kHalRobotDetached,
+};
+
+struct HalRegion {
+	uint32_t magic;
+	uint32_t version;
+
+	// set by the robot side when it attaches and leaves
+	std::atomic<uint32_t> robotState;
+
+	HalRing<HalSensors, 64> sensors;
+	HalRing<HalOutputs, 64> outputs;
+};
+
+// one spin of a busy wait: tells the core we're waiting, and every so often
+// gives the rest of the machine a turn so a single core can't livelock
+inline void halRelax(uint32_t& spins) {
+	if (++spins % 1024 == 0) {
+		std::this_thread::yield();
+		return;
+	}
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+	_mm_pause();
+#elif defined(__aarch64__)
+	asm volatile("yield");
+#endif
+}
+
+#ifndef _WIN32
+
+// The robot side. Opens the sim's region, then loops on waitSensors /
+// sendOutputs.
+class HalClient {
+public:
+	~HalClient() { close(); }
+
+	// name as given to the sim's --hal; false if the sim hasn't created it
+	bool open(char const* name) {
+		int fd = shm_open(name, O_RDWR, 0);
+		if (fd < 0) {
+			return false;
+		}
+		void* p = mmap(nullptr, sizeof(HalRegion), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+		::close(fd);
+		if (p == MAP_FAILED) {
+			return false;
+		}
+		region = static_cast<HalRegion*>(p);
+		if (region->magic != kHalMagic || region->version != kHalVersion) {
+			close();
+			return false;
+		}
+
+		// anything left over is from a previous robot
+		HalSensors stale;
+		while (region->sensors.pop(stale)) {}
+		region->robotState.store(kHalRobotAttached, std::memory_order_release);
+		return true;
+	}
+
+	void close() {
+		if (region) {
+			region->robotState.store(kHalRobotDetached, std::memory_order_release);
+			munmap(region, sizeof(HalRegion));
+			region = nullptr;
+		}
+	}
+
+	// blocks (spinning) until the sim's next robot loop; returns false if
+	// running is cleared first
+	bool waitSensors(HalSensors& sensors, std::atomic<bool> const& running) {
+		uint32_t spins = 0;
+		while (!region->sensors.pop(sensors)) {
+			if (!running.load(std::memory_order_relaxed)) {
+				return false;
+			}
+			halRelax(spins);
+		}
+		return true;
+	}
+
+	void sendOutputs(HalOutputs const& outputs) {
+		// the sim waits for each of these, so the ring can't be full
+		region->outputs.push(outputs);
+	}
+
+private:
+	HalRegion* region = nullptr;
+};
+
+#endif
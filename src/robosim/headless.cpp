@@ -0,0 +1,117 @@
+#include "headless.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+
+#include "determinism.hpp"
+#include "drivetrain.hpp"
+#include "hal_bridge.hpp"
+#include "robot_program.hpp"
+#include "sim.hpp"
+#include "simlog.hpp"
+
+int runHeadless(Options const& opts) {
+	// b2World is big; keep it off the stack
+	auto sim = std::make_unique<Sim>(opts.physicsHz, opts.seed);
+
+	TankDrivetrain drivetrain;
+	if (opts.drivetrain) {
+		sim->attachDrivetrain(drivetrain);
+	}
+
+	RobotProgram program;
+	if (opts.robotPath) {
+		if (!program.load(opts.robotPath)) {
+			return 1;
+		}
+		sim->program = &program;
+	}
+
+	HalBridge hal;
+	if (opts.halName) {
+		if (!hal.open(opts.halName)) {
+			return 1;
+		}
+		printf("waiting for a robot to attach to %s...\n", opts.halName);
+		if (!hal.waitForRobot(30000)) {
+			fprintf(stderr, "no robot attached\n");
+			return 1;
+		}
+		sim->hal = &hal;
+	}
+
+	InputScript script;
+	if (opts.inputPath && !script.load(opts.inputPath)) {
+		return 1;
+	}
+
+	GoldenFile golden;
+	if (opts.goldenPath && (!golden.open(opts.goldenPath) || !golden.matches(opts.physicsHz, opts.seed, opts.seconds, 1))) {
+		return 1;
+	}
+	HashTrace trace;
+	setupTrace(trace, opts, opts.seed, opts.goldenPath ? &golden : nullptr, 0);
+
+	LogWriter log;
+	if (opts.logPath && log.open(opts.logPath, opts.physicsHz, opts.seed)) {
+		sim->log = &log;
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	long steps = 0;
+	bool reported = false;
+	while (sim->time() < opts.seconds) {
+		if (!script.empty()) {
+			sim->input = script.at(sim->time());
+		}
+		sim->step();
+		steps++;
+
+		if (opts.deterministic) {
+			trace.update(*sim);
+			if (trace.divergedAt >= 0 && !reported) {
+				// the state is still here to look at, so say what it was
+				printf("at divergence: bot angle %f, vel %f, pos (%f, %f), %d bodies\n",
+					sim->bot.angle, sim->bot.vel, sim->bot.pos.x, sim->bot.pos.y, sim->world.GetBodyCount());
+				reported = true;
+			}
+		}
+	}
+	log.close();
+	auto end = std::chrono::steady_clock::now();
+
+	double wall = std::chrono::duration<double>(end - start).count();
+	printf("simulated %.2f s (%ld steps) in %.3f s wall\n", sim->time(), steps, wall);
+	printf("sim-seconds per wall-second: %.1f\n", wall > 0 ? sim->time() / wall : 0.0);
+	printf("seed: %u\n", opts.seed);
+	printf("final err: %f, max err: %f\n", sim->err(), sim->maxErr);
+	if (sim->hal) {
+		printf("HAL: %llu round trips, mean %.1f us, max %.1f us\n", static_cast<unsigned long long>(hal.roundTrips), hal.meanRoundTripUs, hal.maxRoundTripUs);
+	}
+
+	if (!opts.deterministic) {
+		return 0;
+	}
+	printf("state hash: %016llx\n", static_cast<unsigned long long>(trace.rolling));
+	if (opts.recordGoldenPath) {
+		GoldenHeader header{};
+		header.physicsHz = opts.physicsHz;
+		header.seed = opts.seed;
+		header.stride = trace.stride;
+		header.seconds = opts.seconds;
+		if (!writeGolden(opts.recordGoldenPath, header, {&trace})) {
+			return 1;
+		}
+		printf("wrote golden trace %s (%zu hashes)\n", opts.recordGoldenPath, trace.hashes.size());
+	}
+	if (opts.goldenPath) {
+		printDivergence(trace, opts.physicsHz, "run");
+		if (trace.divergedAt >= 0 || !trace.complete()) {
+			return 2;
+		}
+		printf("matches golden trace %s\n", opts.goldenPath);
+	}
+
+	return 0;
+}
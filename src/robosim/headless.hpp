@@ -0,0 +1,7 @@
+#pragma once
+
+#include "options.hpp"
+
+// steps the sim with no window or input as fast as the CPU allows, then
+// reports how much faster than realtime it went
+int runHeadless(Options const& opts);
@@ -0,0 +1,90 @@
+#include "imgui_bench.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include <raylib.h>
+
+#include "raylib/raylib-cpp.hpp"
+#include "rlImGui/rlImGui.h"
+#include "imgui.h"
+
+#include "sim.hpp"
+#include "stats.hpp"
+
+constexpr int kWarmupFrames = 30;
+constexpr int kPlots = 48;
+constexpr int kPlotPoints = 1000;
+
+// telemetry-ish: lots of dense plots and text, tens of thousands of verts
+static void drawDashboard(std::vector<float> const& samples, int frame) {
+	ImGui::SetNextWindowPos({0, 0});
+	ImGui::SetNextWindowSize({kFieldWidth, kFieldHeight});
+	ImGui::Begin("bench", nullptr, ImGuiWindowFlags_NoDecoration);
+	for (int i = 0; i < kPlots; i++) {
+		char label[32];
+		snprintf(label, sizeof(label), "channel %d", i);
+		ImGui::PlotLines(label, samples.data(), kPlotPoints, (frame + i * 37) % kPlotPoints, nullptr, -1.5f, 1.5f, {600, 40});
+		if (i % 2 == 0) {
+			ImGui::SameLine();
+		}
+	}
+	for (int i = 0; i < 100; i++) {
+		ImGui::Text("line %d: %f %f %f", i, samples[i], samples[i + 1], samples[i + 2]);
+	}
+	ImGui::End();
+}
+
+int runImGuiBench(Options const& opts) {
+	raylib::Window window(static_cast<int>(kFieldWidth), static_cast<int>(kFieldHeight), "robosim - imgui bench");
+	SetTargetFPS(0);
+	rlImGuiSetup(true);
+
+	std::vector<float> samples(kPlotPoints);
+	for (int i = 0; i < kPlotPoints; i++) {
+		samples[i] = std::sin(i * 0.05f) + 0.3f * std::sin(i * 0.71f);
+	}
+
+	int frames = opts.benchFrames;
+	bool const paths[] = {false, true};
+	for (bool indexed : paths) {
+		rlImGuiSetIndexedRendering(indexed);
+
+		std::vector<float> frameMs, renderMs;
+		for (int frame = 0; frame < kWarmupFrames + frames && !window.ShouldClose(); frame++) {
+			auto frameStart = std::chrono::steady_clock::now();
+
+			BeginDrawing();
+			ClearBackground(DARKGRAY);
+			rlImGuiBegin();
+			drawDashboard(samples, frame);
+
+			auto renderStart = std::chrono::steady_clock::now();
+			rlImGuiEnd();
+			auto renderEnd = std::chrono::steady_clock::now();
+
+			EndDrawing();
+			auto frameEnd = std::chrono::steady_clock::now();
+
+			if (frame >= kWarmupFrames) {
+				renderMs.push_back(std::chrono::duration<float, std::milli>(renderEnd - renderStart).count());
+				frameMs.push_back(std::chrono::duration<float, std::milli>(frameEnd - frameStart).count());
+			}
+		}
+		if (frameMs.empty()) {
+			break;
+		}
+
+		ImDrawData* data = ImGui::GetDrawData();
+		Stats frame = computeStats(frameMs);
+		Stats render = computeStats(renderMs);
+		printf("%-9s %d frames, %d verts/frame: frame %.3f ms mean / %.3f p95, rlImGuiEnd %.3f ms mean / %.3f p95\n",
+			indexed ? "indexed" : "immediate", static_cast<int>(frameMs.size()), data ? data->TotalVtxCount : 0,
+			frame.mean, frame.p95, render.mean, render.p95);
+	}
+
+	rlImGuiShutdown();
+	return 0;
+}
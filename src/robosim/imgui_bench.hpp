@@ -0,0 +1,7 @@
+#pragma once
+
+#include "options.hpp"
+
+// opens a window, draws a deliberately heavy ImGui dashboard through both
+// rlImGui render paths, and prints frame time for each
+int runImGuiBench(Options const& opts);
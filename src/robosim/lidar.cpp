@@ -0,0 +1,107 @@
+#include "lidar.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "segment_bvh.hpp"
+#include "sim.hpp"
+
+namespace {
+
+// every moving, solid fixture in the box but the robot's own
+class NearbyFixtures : public b2QueryCallback {
+public:
+	NearbyFixtures(b2Body const* self, std::vector<b2Fixture*>& out) : self(self), out(out) {}
+
+	bool ReportFixture(b2Fixture* fixture) override {
+		b2Body const* body = fixture->GetBody();
+		if (body != self && body->GetType() != b2_staticBody && !fixture->IsSensor()) {
+			out.push_back(fixture);
+		}
+		return true;
+	}
+
+private:
+	b2Body const* self;
+	std::vector<b2Fixture*>& out;
+};
+
+}
+
+Lidar::Lidar(LidarConfig const& config) : config(config) {
+	int n = config.beams;
+	float step = config.fov / n;
+	beams.resize(n);
+	for (int i = 0; i < n; i++) {
+		beams[i].Set(-config.fov / 2 + (i + 0.5f) * step);
+	}
+	ranges.assign(n, config.range);
+	dirs.resize(n);
+	normals.resize(n);
+	// a match has a few dozen moving bodies; this only grows past that once
+	nearby.reserve(64);
+}
+
+void Lidar::scan(SegmentBvh const& field, b2World const& world, b2Body const* self,
+	b2Vec2 origin, float heading, SensorNoise const& noise)
+{
+	int n = static_cast<int>(beams.size());
+	float range = config.range;
+	b2Rot rot(heading);
+	for (int i = 0; i < n; i++) {
+		dirs[i] = b2Mul(rot, beams[i]).GetXAxis();
+	}
+
+	field.castFan(origin, dirs.data(), n, range, ranges.data());
+
+	nearby.clear();
+	NearbyFixtures gather{self, nearby};
+	b2AABB reach;
+	reach.lowerBound = origin - b2Vec2(range, range);
+	reach.upperBound = origin + b2Vec2(range, range);
+	world.QueryAABB(&gather, reach);
+
+	// only the beams inside each fixture's bounding circle can hit it
+	float step = config.fov / n;
+	bool fullCircle = config.fov >= 2 * b2_pi - 1e-4f;
+	for (b2Fixture* f : nearby) {
+		for (int child = 0; child < f->GetShape()->GetChildCount(); child++) {
+			b2AABB const& box = f->GetAABB(child);
+			b2Vec2 rel = box.GetCenter() - origin;
+			float radius = box.GetExtents().Length();
+			float dist = rel.Length();
+			if (dist - radius > range) {
+				continue;
+			}
+
+			int lo = 0;
+			int hi = n - 1;
+			if (dist > radius) {
+				float half = std::asin(radius / dist);
+				// in beam space: 0 at the first beam's edge, fov at the last's
+				float a = std::remainder(std::atan2(rel.y, rel.x) - heading, 2 * b2_pi) + config.fov / 2;
+				lo = static_cast<int>(std::ceil((a - half) / step - 0.5f));
+				hi = static_cast<int>(std::floor((a + half) / step - 0.5f));
+			}
+
+			for (int k = lo; k <= hi; k++) {
+				int i = fullCircle ? (k % n + n) % n : k;
+				if (i < 0 || i >= n || ranges[i] <= 0) {
+					continue;
+				}
+				b2RayCastInput in{origin, origin + ranges[i] * dirs[i], 1.0f};
+				b2RayCastOutput out;
+				if (f->RayCast(&out, in, child)) {
+					ranges[i] *= out.fraction;
+				}
+			}
+		}
+	}
+
+	noise.fillNormals(kSensorLidar, normals.data(), n);
+	for (int i = 0; i < n; i++) {
+		if (ranges[i] < range) {
+			ranges[i] = std::clamp(ranges[i] + config.stddev * normals[i], 0.0f, range);
+		}
+	}
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <vector>
+
+#include <box2d/box2d.h>
+
+class SegmentBvh;
+struct SensorNoise;
+
+struct LidarConfig {
+	int beams = 360;
+	float fov = 2 * b2_pi;   // radians, centered on the robot's heading
+	float range = 12.0f;     // m; a beam with no return reads this
+	float hz = 20.0f;        // scans per second
+	float stddev = 0.015f;   // m, on every return
+};
+
+// A 2D scanning lidar (or, with a few beams, a ring of distance sensors).
+// Each scan casts every beam against the field's static edges through the
+// segment BVH, then gets the moving bodies near enough to matter from
+// Box2D's broadphase in one query and tests each one only against the
+// beams its bounding circle covers. So there's no per-ray world.RayCast,
+// and no virtual callback per beam.
+//
+// Noise is the Bot sensors' model, keyed by (seed, bot, beam, tick), so a
+// scan is reproducible from the robot's seed. scan() doesn't allocate.
+class Lidar {
+public:
+	explicit Lidar(LidarConfig const& config = {});
+
+	// origin in meters, heading in radians; ignores self's own fixtures
+	void scan(SegmentBvh const& field, b2World const& world, b2Body const* self,
+		b2Vec2 origin, float heading, SensorNoise const& noise);
+
+	// beam i points at heading - fov/2 + (i + 0.5) * fov/beams
+	std::vector<float> ranges;
+
+	LidarConfig config;
+
+private:
+	// beam directions relative to the heading
+	std::vector<b2Rot> beams;
+	std::vector<b2Vec2> dirs;
+	std::vector<float> normals;
+	std::vector<b2Fixture*> nearby;
+};
@@ -1,5 +1,4 @@
-#include <cmath>
-#include <random>
+#include <memory>
 
 #include <raylib.h>
 #include <box2d/box2d.h>
@@ -10,44 +9,110 @@
 #include "imgui.h"
 #include "b2DrawRayLib/b2DrawRayLib.hpp"
 
-std::random_device rd{};
-std::mt19937 gen{rd()};
-std::normal_distribution<float> d{0, 3};
+#include "batch.hpp"
+#include "drivetrain.hpp"
+#include "hal_bridge.hpp"
+#include "headless.hpp"
+#include "imgui_bench.hpp"
+#include "match.hpp"
+#include "options.hpp"
+#include "physics_panel.hpp"
+#include "profiler.hpp"
+#include "render.hpp"
+#include "replay.hpp"
+#include "rng.hpp"
+#include "robot_program.hpp"
+#include "sim.hpp"
+#include "sim_thread.hpp"
+#include "simlog.hpp"
+#include "static_layer.hpp"
+#include "sweep.hpp"
+#include "telemetry.hpp"
+#include "telemetry_ui.hpp"
+
+int main(int argc, char** argv) {
+	Options opts;
+	if (!parseOptions(argc, argv, opts)) {
+		return 1;
+	}
 
-struct Bot {
-	float angle;
-	float vel;
-	Vector2 pos;
+	// every run's noise, and so its replays and golden traces, rest on this
+	if (!philoxSelfTest()) {
+		return 1;
+	}
 
-	float getAngle() {
-		return angle + d(gen);
+	if (opts.replayPath) {
+		return runReplay(opts);
 	}
 
-	float getVel() {
-		return vel + d(gen);
+	if (opts.imguiBench) {
+		return runImGuiBench(opts);
 	}
 
-	Vector2 getPos() {
-		return {pos.x + d(gen), pos.y + d(gen)};
+	if (opts.match) {
+		return runMatch(opts);
 	}
-};
 
-void periodic() {
-}
+	if (opts.sweep > 0) {
+		return runSweep(opts);
+	}
 
-int main() {
-	int screenWidth = 1280;
-	int screenHeight = 720;
+	if (opts.batch > 0) {
+		return runBatch(opts);
+	}
+
+	if (opts.headless) {
+		return runHeadless(opts);
+	}
+
+	int screenWidth = kFieldWidth;
+	int screenHeight = kFieldHeight;
 
 	raylib::Window window(screenWidth, screenHeight, "raylib-cpp - basic window");
 	SetTargetFPS(60);
 	rlImGuiSetup(true);
 
-	Bot bot{0, 0, {screenWidth / 2.0f, screenHeight / 2.0f}};
+	auto sim = std::make_unique<Sim>(opts.physicsHz, opts.seed);
 
-	b2World world(b2Vec2(0, -10));
+	TankDrivetrain drivetrain;
+	if (opts.drivetrain) {
+		sim->attachDrivetrain(drivetrain);
+	}
 
-	b2DrawRayLib drawer{ 10.0f };
+	RobotProgram program;
+	if (opts.robotPath) {
+		if (!program.load(opts.robotPath)) {
+			return 1;
+		}
+		sim->program = &program;
+	}
+
+	// the sim runs free until a robot attaches, then waits on it every loop
+	HalBridge hal;
+	if (opts.halName) {
+		if (!hal.open(opts.halName)) {
+			return 1;
+		}
+		sim->hal = &hal;
+	}
+
+	LogWriter log;
+	if (opts.logPath && log.open(opts.logPath, opts.physicsHz, opts.seed)) {
+		sim->log = &log;
+	}
+
+	Telemetry telemetry;
+	sim->attachTelemetry(telemetry);
+	TelemetryPlots plots{telemetry};
+
+	PhysicsPanel physicsPanel{sim->timeStep * 1000.0f};
+	sim->physicsPanel = &physicsPanel;
+
+	profilerSetThreadName("main");
+	ProfilerView profiler;
+
+	// the chassis' world is in meters across the whole window
+	b2DrawRayLib drawer{ opts.drivetrain ? kPixelsPerMeter : 10.0f };
 	drawer.SetFlags(
         b2Draw::e_shapeBit |
         b2Draw::e_jointBit |
@@ -55,88 +120,132 @@ int main() {
         b2Draw::e_pairBit |
         b2Draw::e_centerOfMassBit
     );
-	world.SetDebugDraw(&drawer);
-
-	b2BodyDef groundBodyDef;
-	groundBodyDef.position.Set(0.0f, -10.0f);
-	b2Body* groundBody = world.CreateBody(&groundBodyDef);
-	b2PolygonShape groundBox;
-	groundBox.SetAsBox(50.0f, 10.0f);
-	groundBody->CreateFixture(&groundBox, 0.0f);
-
-	b2BodyDef bodyDef;
-	bodyDef.type = b2_dynamicBody;
-	bodyDef.position.Set(0.0f, 4.0f);
-	b2Body* body = world.CreateBody(&bodyDef);
-	b2PolygonShape dynamicBox;
-	dynamicBox.SetAsBox(1.0f, 1.0f);
-	b2FixtureDef fixtureDef;
-	fixtureDef.shape = &dynamicBox;
-	fixtureDef.density = 1.0f;
-	fixtureDef.friction = 0.3f;
-	body->CreateFixture(&fixtureDef);
-
-	float timeStep = 1.0f / 60.0f;
-	int32 velocityIterations = 6;
-	int32 positionIterations = 2;
+	drawer.SetBatching(true);
 
-	while (!window.ShouldClose()) {
-		world.Step(timeStep, velocityIterations, positionIterations);
-		
-		// lets try to drive straight, naively
+	StaticLayer staticLayer;
+	bool cacheStatics = true;
 
-		if (bot.getVel() < 2) {
-			bot.vel += 0.06f;
-		}
+	raylib::Camera2D camera{{0, 0}, {0, 0}};
+	bool cull = true;
 
-		if (bot.getPos().y > 360) {
-			bot.angle -= 2.0f - abs(bot.vel / 2);
-		} else {
-			bot.angle += 2.0f - abs(bot.vel / 2);
-		}
+	// from here on only the sim thread touches *sim
+	SimThread simThread{*sim};
+	simThread.start();
+
+	while (!window.ShouldClose()) {
+		simThread.setInput(readKeyboard());
+
+		bool captureNow = IsKeyPressed(KEY_F5);
+		bool restoreNow = IsKeyPressed(KEY_F9);
 
-		if (IsKeyDown(KEY_LEFT)) bot.angle -= 2.0f - abs(bot.vel / 2);
-		if (IsKeyDown(KEY_RIGHT)) bot.angle += 2.0f - abs(bot.vel / 2);
+		panZoomCamera(camera);
+		b2AABB view = drawer.GetVisibleAABB(camera, GetScreenWidth(), GetScreenHeight());
+		simThread.setView(cull ? &view : nullptr);
 
-		if (IsKeyDown(KEY_UP)) bot.vel += 0.06f;
-		if (IsKeyDown(KEY_DOWN)) bot.vel -= 0.06f;
+		RenderFrame const& frame = simThread.latest();
 
-		bot.vel *= 0.975;
-		bot.pos.x += bot.vel * cos(DEG2RAD * bot.angle);
-		bot.pos.y += bot.vel * sin(DEG2RAD * bot.angle);
+		// how far past the frame's step we are, as a fraction of a step
+		float alpha = (profilerNowNs() - frame.publishedNs) / (frame.timeStep * 1e9f);
+		alpha = alpha < 0 ? 0 : alpha > 1 ? 1 : alpha;
 
 		{
 			BeginDrawing();
-			window.ClearBackground(RAYWHITE);
-
-			DrawCircleV(bot.pos, 20.0f, raylib::Color::Red());
 
-			DrawLineEx(bot.pos, {bot.pos.x + (20 * cosf(DEG2RAD * bot.angle)), bot.pos.y + (20 * sinf(DEG2RAD * bot.angle))}, 3, BLACK);
+			{
+				PROFILE_ZONE("draw world");
+				drawer.ResetStats();
+				if (cacheStatics) {
+					staticLayer.draw(frame, drawer, camera, RAYWHITE);
+				} else {
+					window.ClearBackground(RAYWHITE);
+				}
+				camera.BeginMode();
+				drawFrame(frame, alpha, drawer, !cacheStatics);
+				if (drawer.IsBatching()) {
+					drawer.Flush();
+				}
+				camera.EndMode();
+			}
 
 			{
 				rlImGuiBegin();
 
-				ImGui::Text("Velocity: %f", bot.vel);
-				ImGui::Text("Angle: %f", bot.angle);
-				ImGui::Text("Position: (%f, %f)", bot.pos.x, bot.pos.y);
-				float err = pow(bot.pos.y - 360, 2);
-				ImGui::Text("Err: %f", err);
+				ImGui::Text("Sim time: %.2f s (%d Hz)", frame.time, frame.physicsHz);
+				ImGui::Text("Velocity: %f", frame.bot.vel);
+				ImGui::Text("Angle: %f", frame.bot.angle);
+				ImGui::Text("Position: (%f, %f)", frame.bot.pos.x, frame.bot.pos.y);
+				ImGui::Text("Err: %f", frame.err);
+				ImGui::Text("Max Err: %f", frame.maxErr);
+				if (frame.programReloads >= 0) {
+					ImGui::Text("Robot program: %s (%d reloads)", opts.robotPath, frame.programReloads);
+				}
+				if (frame.hal) {
+					if (frame.halAttached) {
+						ImGui::Text("HAL %s: attached, round trip mean %.1f us, max %.1f us", opts.halName, frame.halMeanUs, frame.halMaxUs);
+					} else {
+						ImGui::Text("HAL %s: waiting for a robot", opts.halName);
+					}
+				}
 
-				static float maxErr;
-				if (err > maxErr) {
-					maxErr = err;
+				bool indexed = rlImGuiIsIndexedRendering();
+				if (ImGui::Checkbox("Indexed ImGui rendering", &indexed)) {
+					rlImGuiSetIndexedRendering(indexed);
 				}
 
-				ImGui::Text("Max Err: %f", maxErr);
+				bool batching = drawer.IsBatching();
+				if (ImGui::Checkbox("Batch debug draw", &batching)) {
+					drawer.SetBatching(batching);
+				}
+				auto const& drawStats = drawer.GetStats();
+				ImGui::Text("Debug draw: %d draw calls, %d verts (%d tris, %d segs)", drawStats.drawCalls, drawStats.vertices, drawStats.triangles, drawStats.segments);
+
+				ImGui::Checkbox("Cache static bodies", &cacheStatics);
+				ImGui::SameLine();
+				ImGui::Text("(%d redraws)", staticLayer.redraws());
+
+				ImGui::Checkbox("Cull to view", &cull);
+				ImGui::SameLine();
+				ImGui::Text("(%d of %d moving fixtures captured, zoom %.2fx)", frame.capturedFixtures, frame.fixtures, camera.zoom);
+
+				ImGui::Separator();
+				captureNow |= ImGui::Button("Snapshot (F5)");
+				ImGui::SameLine();
+				restoreNow |= ImGui::Button("Restore (F9)");
+				if (frame.haveSnapshot) {
+					float budgetUs = frame.timeStep * 1e6f;
+					ImGui::Text("Snapshot: %zu bytes, capture %.1f us, restore %.1f us (%.1f%% of a step)", frame.snapshotBytes, frame.captureUs, frame.restoreUs, 100.0f * frame.restoreUs / budgetUs);
+					if (frame.restoreFailed) {
+						ImGui::TextColored({1, 0.4f, 0.4f, 1}, "Restore failed: bodies were added or removed since the snapshot");
+					}
+				}
 
+				plots.drain();
+				plots.draw(frame.time);
+				profiler.draw();
+				physicsPanel.drain();
+				physicsPanel.draw();
+
+				PROFILE_ZONE("rlImGuiEnd");
 				rlImGuiEnd();
 			}
 
-			world.DebugDraw();
-
+			PROFILE_ZONE("EndDrawing");
 			EndDrawing();
 		}
+
+		// the sim thread does these between steps
+		if (captureNow) {
+			simThread.requestCapture();
+		}
+		if (restoreNow) {
+			simThread.requestRestore();
+		}
+
+		profiler.endFrame();
 	}
 
+	simThread.stop();
+	log.close();
+
 	return 0;
 }
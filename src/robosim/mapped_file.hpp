@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+
+// Read-only memory map of a whole file. Pages come in on demand, so
+// opening a big file is cheap and only the parts that are touched cost
+// anything.
+class MappedFile {
+public:
+	MappedFile() = default;
+	MappedFile(MappedFile const&) = delete;
+	MappedFile& operator=(MappedFile const&) = delete;
+	~MappedFile();
+
+	// prints the reason and returns false on failure
+	bool open(char const* path);
+	void close();
+
+	unsigned char const* data() const { return bytes; }
+	size_t size() const { return length; }
+
+private:
+	unsigned char const* bytes = nullptr;
+	size_t length = 0;
+
+#ifdef _WIN32
+	void* file = nullptr;
+	void* mapping = nullptr;
+#endif
+};
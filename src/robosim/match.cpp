@@ -0,0 +1,438 @@
+#include "match.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+#include "profiler.hpp"
+#include "robot.hpp"
+#include "robot_program.hpp"
+
+// where scattered and returned pieces land: this far from either
+// alliance wall, clear of both communities
+constexpr float kMiddleMargin = 5.5f;
+
+// the built-in controller's top speed, m/s
+constexpr float kMatchSpeed = 3.5f;
+
+b2Filter collisionFilter(CollisionCategory category) {
+	b2Filter filter;
+	filter.categoryBits = category;
+	switch (category) {
+	case kCategoryWall:
+	case kCategoryFieldElement:
+		filter.maskBits = kCategoryBumper | kCategoryGamePiece;
+		break;
+	case kCategoryBumper:
+		filter.maskBits = kCategoryWall | kCategoryFieldElement | kCategoryBumper | kCategoryGamePiece;
+		break;
+	case kCategoryGamePiece:
+		filter.maskBits = kCategoryWall | kCategoryFieldElement | kCategoryBumper | kCategoryGamePiece | kCategoryIntake;
+		break;
+	case kCategoryIntake:
+		filter.maskBits = kCategoryGamePiece;
+		break;
+	}
+	return filter;
+}
+
+static void setFilter(b2Body* body, CollisionCategory category) {
+	for (b2Fixture* f = body->GetFixtureList(); f; f = f->GetNext()) {
+		f->SetFilterData(collisionFilter(category));
+	}
+}
+
+static float wrapAngle(float a) {
+	return std::remainder(a, 2 * b2_pi);
+}
+
+// a uniform point in the middle of the field, from one philox block
+static b2Vec2 middlePoint(Field const& field, PhiloxCounter ctr, PhiloxKey key) {
+	auto bits = philox(ctr, key);
+	float u = (bits[0] >> 8) * 0x1p-24f;
+	float v = (bits[1] >> 8) * 0x1p-24f;
+	return {
+		kMiddleMargin + u * (field.length() - 2 * kMiddleMargin),
+		0.5f + v * (field.width() - 1.0f),
+	};
+}
+
+MatchRobot::MatchRobot(Alliance alliance, uint32_t seed, uint32_t botId)
+	: alliance(alliance)
+	, noise(seed, botId)
+{
+}
+
+Match::Match(int physicsHz, uint32_t seed, Field const& field)
+	: field(field)
+	, vision(field, fieldEdges, physicsHz)
+	, physicsHz(physicsHz)
+	, timeStep(1.0f / physicsHz)
+	, key{seed, 0x3a7c4}
+	, ticksPerPeriodic(physicsHz / kRobotHz)
+	, substeps((kDrivetrainHz + physicsHz - 1) / physicsHz)
+{
+	field.build(world, collisionFilter(kCategoryWall), collisionFilter(kCategoryFieldElement));
+	fieldEdges.build(field);
+
+	// the built-in controller aims for the middle of its scoring zone
+	uint32_t zoneCount;
+	FieldZone const* zones = field.zones(zoneCount);
+	for (int side = 0; side < 2; side++) {
+		scoreX[side] = side == kRed ? field.length() - 0.8f : 0.8f;
+		for (uint32_t i = 0; i < zoneCount; i++) {
+			if (zones[i].alliance == side && zones[i].flags & kZoneScoring) {
+				b2Vec2 const* v = field.zoneVertices() + zones[i].first;
+				float sum = 0;
+				for (uint32_t j = 0; j < zones[i].count; j++) {
+					sum += v[j].x;
+				}
+				scoreX[side] = sum / zones[i].count;
+				break;
+			}
+		}
+	}
+
+	// same starting spots as the bench scenes: three per alliance at each
+	// end, facing the middle
+	robots.reserve(kMatchRobots);
+	for (int i = 0; i < kMatchRobots; i++) {
+		Alliance alliance = i % 2 == 0 ? kBlue : kRed;
+		MatchRobot& robot = robots.emplace_back(alliance, seed, i);
+
+		float x = alliance == kRed ? field.length() - 2.0f : 2.0f;
+		float y = field.width() * (1 + i / 2) / 4.0f;
+		b2Body* body = robot.drivetrain.create(world, {x, y}, alliance == kRed ? b2_pi : 0);
+		setFilter(body, kCategoryBumper);
+
+		// a sensor strip across the front bumper; it only ever touches game
+		// pieces, and never pushes them
+		float half = robot.drivetrain.config.length / 2;
+		b2PolygonShape intake;
+		intake.SetAsBox(0.1f, half * 0.7f, {half + 0.1f, 0}, 0);
+		b2FixtureDef fixture;
+		fixture.shape = &intake;
+		fixture.isSensor = true;
+		fixture.filter = collisionFilter(kCategoryIntake);
+		body->CreateFixture(&fixture);
+	}
+
+	gamePieces.reserve(world, kMatchGamePieces, collisionFilter(kCategoryGamePiece));
+	for (int i = 0; i < kMatchGamePieces; i++) {
+		gamePieces.spawn(middlePoint(field, {static_cast<uint32_t>(i), 0, 0, 0}, key));
+	}
+}
+
+bool Match::loadPrograms(char const* path) {
+	for (MatchRobot& robot : robots) {
+		robot.program = std::make_unique<RobotProgram>();
+		// the program sees the real field in the bot's pixel units
+		robot.program->ctx.fieldWidth = field.length() * kPixelsPerMeter;
+		robot.program->ctx.fieldHeight = field.width() * kPixelsPerMeter;
+		if (!robot.program->load(path)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// where to aim on the way to target so the chassis doesn't pin itself on a
+// field element: over the element's top corners, on the near side until
+// the robot is clear of it, then the far side
+static b2Vec2 detour(Field const& field, b2Vec2 from, b2Vec2 target) {
+	float margin = 0.7f;
+	uint32_t count;
+	FieldPolygon const* elements = field.polygons(count);
+	for (uint32_t i = 0; i < count; i++) {
+		b2AABB box = elements[i].bounds;
+		box.lowerBound -= b2Vec2(margin, margin);
+		box.upperBound += b2Vec2(margin, margin);
+		b2Vec2 center = box.GetCenter();
+
+		b2RayCastInput ray{from, target, 1.0f};
+		b2RayCastOutput out;
+		bool inside = from.x > box.lowerBound.x && from.x < box.upperBound.x
+			&& from.y > box.lowerBound.y && from.y < box.upperBound.y;
+		if (inside || !box.RayCast(&out, ray)) {
+			continue;
+		}
+		bool over = from.y >= box.upperBound.y - 0.05f;
+		bool towardLeft = (over ? target.x : from.x) < center.x;
+		return {towardLeft ? box.lowerBound.x : box.upperBound.x, box.upperBound.y + 0.1f};
+	}
+	return target;
+}
+
+void Match::runController(MatchRobot& robot) {
+	// the same noisy readings a program would get, back in meters
+	b2Vec2 pos = robot.drivetrain.body->GetPosition();
+	pos += (1 / kPixelsPerMeter) * b2Vec2(robot.noise.sample(kSensorPosX), robot.noise.sample(kSensorPosY));
+	float angle = robot.drivetrain.body->GetAngle() + DEG2RAD * robot.noise.sample(kSensorAngle);
+
+	b2Vec2 target = pos;
+	if (robot.carrying) {
+		// one lane per robot along the upper half of the alliance wall,
+		// clear of the charge station on the 2023 field
+		int lane = static_cast<int>(&robot - robots.data()) / 2;
+		target.x = scoreX[robot.alliance];
+		target.y = field.width() * (0.56f + 0.15f * lane);
+	} else {
+		float best = b2_maxFloat;
+		for (b2Body* piece : gamePieces.pieces()) {
+			if (!piece->IsEnabled()) {
+				continue;
+			}
+			float d = b2DistanceSquared(pos, piece->GetPosition());
+			if (d < best) {
+				best = d;
+				target = piece->GetPosition();
+			}
+		}
+	}
+
+	b2Vec2 to = detour(field, pos, target) - pos;
+	DrivetrainState& state = robot.drivetrain.state;
+	if (to.LengthSquared() < 0.01f) {
+		state.targetSpeed = 0;
+		return;
+	}
+	// held as an absolute heading, so keep it next to where we are
+	float error = wrapAngle(std::atan2(to.y, to.x) - angle);
+	state.targetHeading = robot.drivetrain.body->GetAngle() + error;
+	state.targetSpeed = kMatchSpeed * std::max(0.0f, std::cos(error)) * std::min(1.0f, to.Length());
+}
+
+void Match::runProgram(MatchRobot& robot) {
+	// the same units and readings Sim gives a program driving a chassis
+	b2Body const* body = robot.drivetrain.body;
+	RobotLoopIo io{};
+	io.time = time();
+	io.angle = RAD2DEG * body->GetAngle();
+	io.vel = robot.drivetrain.speed() * kPixelsPerMeter / kTuningRate;
+	io.sensedAngle = io.angle + robot.noise.sample(kSensorAngle);
+	io.sensedVel = io.vel + robot.noise.sample(kSensorVel);
+	io.sensedPosX = body->GetPosition().x * kPixelsPerMeter + robot.noise.sample(kSensorPosX);
+	io.sensedPosY = body->GetPosition().y * kPixelsPerMeter + robot.noise.sample(kSensorPosY);
+	readCameras(robot, &io);
+
+	robot.program->periodic(io);
+
+	robot.drivetrain.state.targetSpeed = io.vel * kTuningRate / kPixelsPerMeter;
+	robot.drivetrain.state.targetHeading = DEG2RAD * io.angle;
+}
+
+void Match::collect(MatchRobot& robot) {
+	b2Body* body = robot.drivetrain.body;
+	if (robot.carrying) {
+		uint32_t zoneCount;
+		FieldZone const* zones = field.zones(zoneCount);
+		bool home = false;
+		for (uint32_t i = 0; i < zoneCount && !home; i++) {
+			home = zones[i].alliance == robot.alliance && zones[i].flags & kZoneScoring
+				&& field.inZone(zones[i], body->GetPosition());
+		}
+		if (home) {
+			score[robot.alliance]++;
+			robot.scored++;
+			respawnPiece();
+			robot.carrying = false;
+		}
+		return;
+	}
+
+	// the intake's contacts are only ever with game pieces, so any touching
+	// one is a pickup
+	for (b2ContactEdge* edge = body->GetContactList(); edge; edge = edge->next) {
+		b2Contact* c = edge->contact;
+		if (!c->IsTouching() || !(c->GetFixtureA()->IsSensor() || c->GetFixtureB()->IsSensor())) {
+			continue;
+		}
+		robot.carrying = true;
+		pickups++;
+		// this drops the piece's contacts, edge included
+		gamePieces.despawn(edge->other);
+		break;
+	}
+}
+
+void Match::respawnPiece() {
+	// keyed by its own count, so every return lands somewhere new and the
+	// same match puts them back in the same places
+	gamePieces.spawn(middlePoint(field, {respawns++, 0, 1, 0}, key));
+}
+
+void Match::addLidars(LidarConfig const& config) {
+	ticksPerScan = std::max(1, static_cast<int>(std::lround(physicsHz / config.hz)));
+	for (MatchRobot& robot : robots) {
+		robot.lidar = std::make_unique<Lidar>(config);
+	}
+}
+
+void Match::addCameras(CameraConfig const& config, int perRobot) {
+	for (MatchRobot& robot : robots) {
+		float half = robot.drivetrain.config.length / 2;
+		for (int i = 0; i < perRobot; i++) {
+			CameraConfig cam = config;
+			cam.yaw = 2 * b2_pi * i / perRobot;
+			cam.mount = half * b2Vec2(std::cos(cam.yaw), std::sin(cam.yaw));
+			robot.cameras.push_back(vision.addCamera(robot.drivetrain.body, robot.noise, cam));
+			robot.framesRead.push_back(-1);
+		}
+	}
+}
+
+void Match::readCameras(MatchRobot& robot, RobotLoopIo* io) {
+	for (size_t i = 0; i < robot.cameras.size(); i++) {
+		CameraFrame frame = vision.frame(robot.cameras[i], tick);
+		if (frame.tick <= robot.framesRead[i]) {
+			continue;
+		}
+		robot.framesRead[i] = frame.tick;
+		framesDelivered++;
+		tagsDelivered += frame.count;
+		deliveredAgeTicks += tick - frame.tick;
+
+		// the built-in controller drives on pose alone; only programs get these
+		for (int k = 0; io && k < frame.count && io->sightingCount < ROBOT_MAX_SIGHTINGS; k++) {
+			TagSighting const& s = frame.sightings[k];
+			RobotTagSighting& out = io->sightings[io->sightingCount++];
+			out.tag = s.tag;
+			out.camera = static_cast<int32_t>(i);
+			out.captureTime = frame.tick / static_cast<double>(physicsHz);
+			out.range = s.range;
+			out.bearing = s.bearing;
+			out.yaw = s.yaw;
+		}
+	}
+}
+
+void Match::scanLidars() {
+	PROFILE_ZONE("lidar");
+	auto start = std::chrono::steady_clock::now();
+	for (MatchRobot& robot : robots) {
+		b2Body const* body = robot.drivetrain.body;
+		robot.noise.tick = tick;
+		robot.lidar->scan(fieldEdges, world, body, body->GetPosition(), body->GetAngle(), robot.noise);
+		lidarScans++;
+	}
+	// timing only; it never feeds back into the sim
+	lidarSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void Match::step() {
+	PROFILE_ZONE("Match::step");
+
+	if (tick % ticksPerPeriodic == 0) {
+		PROFILE_ZONE("periodic");
+		for (MatchRobot& robot : robots) {
+			robot.noise.tick = tick;
+			if (robot.program) {
+				runProgram(robot);
+			} else {
+				readCameras(robot, nullptr);
+				runController(robot);
+			}
+		}
+	}
+
+	float dt = timeStep / substeps;
+	for (int i = 0; i < substeps; i++) {
+		for (MatchRobot& robot : robots) {
+			robot.drivetrain.update(dt);
+		}
+		PROFILE_ZONE("b2World::Step");
+		world.Step(dt, 6, 2);
+		contactUpdates += world.GetContactCount();
+	}
+
+	for (MatchRobot& robot : robots) {
+		collect(robot);
+	}
+
+	if (ticksPerScan > 0 && tick % ticksPerScan == 0) {
+		scanLidars();
+	}
+
+	if (vision.cameraCount() > 0) {
+		auto start = std::chrono::steady_clock::now();
+		vision.capture(tick);
+		visionSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	tick++;
+}
+
+double Match::time() const {
+	return tick / static_cast<double>(physicsHz);
+}
+
+int runMatch(Options const& opts) {
+	Field field;
+	auto loadStart = std::chrono::steady_clock::now();
+	if (opts.fieldPath) {
+		if (!field.load(opts.fieldPath)) {
+			return 1;
+		}
+	} else {
+		field.load(chargedUpField());
+	}
+	double loadMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - loadStart).count();
+	printf("field: %s (%s in %.2f ms)\n", field.name(), field.cached() ? "mapped from cache" : "compiled", loadMs);
+
+	// b2World is big; keep it off the stack
+	auto match = std::make_unique<Match>(opts.physicsHz, opts.seed, field);
+	if (opts.robotPath && !match->loadPrograms(opts.robotPath)) {
+		return 1;
+	}
+	if (opts.lidarBeams > 0) {
+		LidarConfig lidar;
+		lidar.beams = opts.lidarBeams;
+		lidar.hz = opts.lidarHz;
+		match->addLidars(lidar);
+		printf("lidar: %d beams at %.0f Hz against %d field segments (%d BVH nodes)\n",
+			lidar.beams, lidar.hz, match->fieldEdges.segmentCount(), match->fieldEdges.nodeCount());
+	}
+	if (opts.cameras > 0) {
+		CameraConfig camera;
+		camera.latency = opts.cameraLatency;
+		match->addCameras(camera, opts.cameras);
+		uint32_t tagCount;
+		field.tags(tagCount);
+		printf("vision: %d cameras per robot at %.0f fps, %.0f ms latency, %u field tags\n",
+			opts.cameras, camera.fps, camera.latency * 1000, tagCount);
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	while (match->time() < opts.seconds) {
+		match->step();
+	}
+	auto end = std::chrono::steady_clock::now();
+
+	double wall = std::chrono::duration<double>(end - start).count();
+	printf("match: %.2f s (%lld ticks) in %.3f s wall, seed %u\n", match->time(), static_cast<long long>(match->tick), wall, opts.seed);
+	printf("sim-seconds per wall-second: %.1f\n", wall > 0 ? match->time() / wall : 0.0);
+	printf("score: blue %d, red %d (%d pickups)\n", match->score[kBlue], match->score[kRed], match->pickups);
+	for (size_t i = 0; i < match->robots.size(); i++) {
+		MatchRobot const& robot = match->robots[i];
+		printf("  robot %zu (%s): %d scored\n", i, robot.alliance == kBlue ? "blue" : "red", robot.scored);
+	}
+	printf("narrowphase contact updates: %lld (%.1f per tick)\n", static_cast<long long>(match->contactUpdates), match->contactUpdates / static_cast<double>(match->tick));
+	if (match->lidarScans > 0) {
+		printf("lidar scans: %lld, %.1f us each\n", static_cast<long long>(match->lidarScans), match->lidarSeconds * 1e6 / match->lidarScans);
+	}
+	Vision const& vision = match->vision;
+	if (vision.frames > 0) {
+		// every robot's cameras expose on the same ticks
+		double robotFrames = vision.frames / static_cast<double>(opts.cameras);
+		printf("vision frames: %lld, %.2f sight lines and %.2f tags seen per frame, %.2f us per robot per frame\n",
+			static_cast<long long>(vision.frames), vision.sightLines / static_cast<double>(vision.frames),
+			vision.sightings / static_cast<double>(vision.frames), match->visionSeconds * 1e6 / robotFrames);
+	}
+	if (match->framesDelivered > 0) {
+		printf("camera frames read by robot loops: %lld with %lld tags, %.1f ms old on average\n",
+			static_cast<long long>(match->framesDelivered), static_cast<long long>(match->tagsDelivered),
+			match->deliveredAgeTicks * 1000.0 / match->framesDelivered / match->physicsHz);
+	}
+	return 0;
+}
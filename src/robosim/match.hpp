@@ -0,0 +1,145 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <box2d/box2d.h>
+
+#include "drivetrain.hpp"
+#include "field.hpp"
+#include "game_pieces.hpp"
+#include "lidar.hpp"
+#include "options.hpp"
+#include "segment_bvh.hpp"
+#include "sim.hpp"
+#include "vision.hpp"
+
+class RobotProgram;
+struct RobotLoopIo;
+
+// What each fixture is, for Box2D's category/mask filtering. A pair whose
+// masks don't accept each other never gets a contact, so it's dropped in
+// the broadphase before any narrowphase work: intakes only ever see game
+// pieces, and walls and field elements never see each other.
+enum CollisionCategory : uint16 {
+	kCategoryWall = 1 << 0,
+	kCategoryFieldElement = 1 << 1,
+	kCategoryBumper = 1 << 2,
+	kCategoryGamePiece = 1 << 3,
+	kCategoryIntake = 1 << 4,
+};
+
+b2Filter collisionFilter(CollisionCategory category);
+
+constexpr int kMatchRobots = 6;
+constexpr int kMatchGamePieces = 30;
+
+enum Alliance {
+	kBlue,
+	kRed,
+};
+
+struct MatchRobot {
+	Alliance alliance;
+	TankDrivetrain drivetrain;
+	SensorNoise noise;
+
+	// this robot's own copy of the program, when one was given; otherwise
+	// it runs the built-in match controller
+	std::unique_ptr<RobotProgram> program;
+
+	// mounted at the chassis center when the match has lidars
+	std::unique_ptr<Lidar> lidar;
+
+	// this robot's cameras in Match::vision, and the exposure tick of the
+	// newest frame each has handed its loop
+	std::vector<int> cameras;
+	std::vector<int64_t> framesRead;
+
+	// a piece is in the intake; it's parked in the pool until it's scored
+	bool carrying = false;
+	int scored = 0;
+
+	MatchRobot(Alliance alliance, uint32_t seed, uint32_t botId);
+};
+
+// A 3v3 match on a real field: six tank drivetrains with bumpers and
+// front intakes, the field's walls and elements, and game pieces scattered
+// around the middle. Robots pick up a piece by touching it with their
+// intake and score it by carrying it into one of their alliance's scoring
+// zones, after which it goes back onto the field. Everything is in meters,
+// top-down, no gravity.
+//
+// Seeded and stepped in a fixed order, so a match replays exactly.
+class Match {
+public:
+	// physicsHz must be a multiple of kRobotHz; drivetrains are substepped
+	// to kDrivetrainHz either way. field must outlive the match.
+	Match(int physicsHz, uint32_t seed, Field const& field);
+
+	// gives every robot its own instance of the program at path
+	bool loadPrograms(char const* path);
+
+	// gives every robot a lidar, scanned config.hz times a second
+	void addLidars(LidarConfig const& config);
+
+	// gives every robot perRobot cameras, facing evenly around it from the
+	// edge of its chassis, the first straight ahead
+	void addCameras(CameraConfig const& config, int perRobot);
+
+	void step();
+
+	double time() const;
+
+	Field const& field;
+	b2World world{b2Vec2(0, 0)};
+	std::vector<MatchRobot> robots;
+	GamePiecePool gamePieces;
+
+	// the field's static edges, for lidar beams and camera sight lines
+	SegmentBvh fieldEdges;
+
+	// every robot's cameras; robot i's are [i * perRobot, (i + 1) * perRobot)
+	Vision vision;
+
+	int physicsHz;
+	float timeStep;
+	int64_t tick = 0;
+
+	int score[2] = {};
+	int pickups = 0;
+
+	// contacts that reached narrowphase, summed over every substep
+	int64_t contactUpdates = 0;
+
+	int64_t lidarScans = 0;
+	double lidarSeconds = 0;
+	double visionSeconds = 0;
+
+	// camera frames handed to the robot loops once their latency passed
+	// (sightings go into a program's RobotLoopIo), the tags in them, and
+	// how old they were when handed over
+	int64_t framesDelivered = 0;
+	int64_t tagsDelivered = 0;
+	int64_t deliveredAgeTicks = 0;
+
+private:
+	void runController(MatchRobot& robot);
+	void runProgram(MatchRobot& robot);
+	void collect(MatchRobot& robot);
+	void respawnPiece();
+	void scanLidars();
+	void readCameras(MatchRobot& robot, RobotLoopIo* io);
+
+	PhiloxKey key;
+	uint32_t respawns = 0;
+	float scoreX[2];
+	int ticksPerPeriodic;
+	int substeps;
+	int ticksPerScan = 0;
+};
+
+// plays one match headless as fast as it'll go and reports the score and
+// how much faster than realtime it ran
+int runMatch(Options const& opts);
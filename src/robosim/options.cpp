@@ -0,0 +1,198 @@
+#include "options.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+
+#include "robot.hpp"
+
+static void printUsage(char const* prog) {
+	fprintf(stderr,
+		"usage: %s [options]\n"
+		"  --headless       run without a window, as fast as possible\n"
+		"  --seconds <s>    sim time to cover when headless (default 150)\n"
+		"  --hz <rate>      physics rate, a multiple of 50 (default 200)\n"
+		"  --seed <n>       base seed for sensor noise (default random)\n"
+		"  --deterministic  seed, input and stepping fixed, state hashed every tick\n"
+		"                   (--headless and --batch only)\n"
+		"  --input <path>   scripted driver input instead of the keyboard\n"
+		"  --golden <path>  check the state hashes against a recorded run and\n"
+		"                   report the first tick that differs\n"
+		"  --record-golden <path>  write this run's state hashes\n"
+		"  --hash-stride <n>  ticks per recorded hash (default 1)\n"
+		"  --batch <n>      run n independent headless sims and report stats\n"
+		"  --threads <n>    worker threads for --batch (default one per core)\n"
+		"  --sweep <n>      step n bots with no world in one SoA batch\n"
+		"  --no-simd        use the scalar kinematics path for --sweep\n"
+		"  --log <path>     where to write the per-tick log (default robosim.rslog)\n"
+		"  --no-log         don't write a log\n"
+		"  --replay <path>  scrub through a log instead of simulating\n"
+		"  --robot <path>   run this robot program library, reloading it when it\n"
+		"                   changes (windowed and --headless only)\n"
+		"  --hal <name>     let a robot process drive the bot in lockstep through\n"
+		"                   shared memory (windowed and --headless only)\n"
+		"  --drivetrain     make the bot a tank drive chassis with motor, battery and\n"
+		"                   tire physics instead of a point that goes where it's told\n"
+		"  --match          play a 3v3 match on the real field, headless, one program\n"
+		"                   instance per robot when --robot is given\n"
+		"  --field <path>   field file for --match (default: built-in 2023 field)\n"
+		"  --lidar <beams>  give every --match robot a 360 degree lidar\n"
+		"  --lidar-hz <hz>  lidar scans per second (default 20)\n"
+		"  --cameras <n>    give every --match robot n AprilTag cameras facing evenly\n"
+		"                   around it\n"
+		"  --camera-latency <ms>  exposure to result delay (default 50)\n"
+		"  --imgui-bench    time both rlImGui render paths on a heavy dashboard\n"
+		"  --frames <n>     frames per path for --imgui-bench (default 600)\n",
+		prog
+	);
+}
+
+bool parseOptions(int argc, char** argv, Options& opts) {
+	for (int i = 1; i < argc; i++) {
+		char const* arg = argv[i];
+		char const* next = i + 1 < argc ? argv[i + 1] : nullptr;
+
+		if (strcmp(arg, "--headless") == 0) {
+			opts.headless = true;
+		} else if (strcmp(arg, "--seconds") == 0 && next) {
+			opts.seconds = strtof(next, nullptr);
+			i++;
+		} else if (strcmp(arg, "--hz") == 0 && next) {
+			opts.physicsHz = atoi(next);
+			i++;
+		} else if (strcmp(arg, "--seed") == 0 && next) {
+			opts.seed = strtoul(next, nullptr, 0);
+			opts.seedGiven = true;
+			i++;
+		} else if (strcmp(arg, "--deterministic") == 0) {
+			opts.deterministic = true;
+		} else if (strcmp(arg, "--input") == 0 && next) {
+			opts.inputPath = next;
+			i++;
+		} else if (strcmp(arg, "--golden") == 0 && next) {
+			opts.goldenPath = next;
+			i++;
+		} else if (strcmp(arg, "--record-golden") == 0 && next) {
+			opts.recordGoldenPath = next;
+			i++;
+		} else if (strcmp(arg, "--hash-stride") == 0 && next) {
+			opts.hashStride = atoi(next);
+			i++;
+		} else if (strcmp(arg, "--batch") == 0 && next) {
+			opts.batch = atoi(next);
+			i++;
+		} else if (strcmp(arg, "--threads") == 0 && next) {
+			opts.threads = atoi(next);
+			i++;
+		} else if (strcmp(arg, "--sweep") == 0 && next) {
+			opts.sweep = atoi(next);
+			i++;
+		} else if (strcmp(arg, "--no-simd") == 0) {
+			opts.noSimd = true;
+		} else if (strcmp(arg, "--log") == 0 && next) {
+			opts.logPath = next;
+			i++;
+		} else if (strcmp(arg, "--no-log") == 0) {
+			opts.logPath = nullptr;
+		} else if (strcmp(arg, "--replay") == 0 && next) {
+			opts.replayPath = next;
+			i++;
+		} else if (strcmp(arg, "--robot") == 0 && next) {
+			opts.robotPath = next;
+			i++;
+		} else if (strcmp(arg, "--hal") == 0 && next) {
+			opts.halName = next;
+			i++;
+		} else if (strcmp(arg, "--drivetrain") == 0) {
+			opts.drivetrain = true;
+		} else if (strcmp(arg, "--match") == 0) {
+			opts.match = true;
+		} else if (strcmp(arg, "--field") == 0 && next) {
+			opts.fieldPath = next;
+			i++;
+		} else if (strcmp(arg, "--lidar") == 0 && next) {
+			opts.lidarBeams = atoi(next);
+			i++;
+		} else if (strcmp(arg, "--lidar-hz") == 0 && next) {
+			opts.lidarHz = strtof(next, nullptr);
+			i++;
+		} else if (strcmp(arg, "--cameras") == 0 && next) {
+			opts.cameras = atoi(next);
+			i++;
+		} else if (strcmp(arg, "--camera-latency") == 0 && next) {
+			opts.cameraLatency = strtof(next, nullptr) / 1000;
+			i++;
+		} else if (strcmp(arg, "--imgui-bench") == 0) {
+			opts.imguiBench = true;
+		} else if (strcmp(arg, "--frames") == 0 && next) {
+			opts.benchFrames = atoi(next);
+			i++;
+		} else {
+			fprintf(stderr, "unknown or incomplete argument: %s\n", arg);
+			printUsage(argv[0]);
+			return false;
+		}
+	}
+
+	if (opts.seconds <= 0) {
+		fprintf(stderr, "--seconds must be positive\n");
+		return false;
+	}
+
+	if (opts.physicsHz <= 0 || opts.physicsHz % kRobotHz != 0) {
+		fprintf(stderr, "--hz must be a positive multiple of %d\n", kRobotHz);
+		return false;
+	}
+
+	if (opts.batch < 0 || opts.threads < 0 || opts.sweep < 0 || opts.benchFrames <= 0) {
+		fprintf(stderr, "--batch, --threads and --sweep can't be negative, --frames must be positive\n");
+		return false;
+	}
+
+	if (opts.robotPath && opts.halName) {
+		fprintf(stderr, "--robot and --hal both drive the bot; pick one\n");
+		return false;
+	}
+
+	if (opts.lidarBeams < 0 || opts.lidarHz <= 0 || opts.lidarHz > opts.physicsHz) {
+		fprintf(stderr, "--lidar can't be negative, and --lidar-hz must be positive and no more than --hz\n");
+		return false;
+	}
+
+	if (opts.cameras < 0 || opts.cameraLatency < 0) {
+		fprintf(stderr, "--cameras and --camera-latency can't be negative\n");
+		return false;
+	}
+
+	if (opts.match && opts.halName) {
+		fprintf(stderr, "--hal drives a single bot and can't be used with --match\n");
+		return false;
+	}
+
+	// golden traces only mean anything for deterministic runs
+	if (opts.goldenPath || opts.recordGoldenPath) {
+		opts.deterministic = true;
+	}
+
+	if (opts.deterministic) {
+		if (!opts.headless && opts.batch == 0) {
+			fprintf(stderr, "--deterministic needs --headless or --batch\n");
+			return false;
+		}
+		if (opts.robotPath || opts.halName) {
+			fprintf(stderr, "--deterministic can't be used with --robot or --hal\n");
+			return false;
+		}
+		if (opts.hashStride <= 0) {
+			fprintf(stderr, "--hash-stride must be positive\n");
+			return false;
+		}
+	}
+
+	if (!opts.seedGiven) {
+		opts.seed = opts.deterministic ? kDeterministicSeed : std::random_device{}();
+	}
+
+	return true;
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstdint>
+
+// what --deterministic runs use when no --seed is given
+constexpr uint32_t kDeterministicSeed = 2175;
+
+struct Options {
+	bool headless = false;
+
+	// how much sim time a headless run covers; defaults to a full match
+	float seconds = 150.0f;
+
+	// physics and bot kinematics rate, independent of the display
+	int physicsHz = 200;
+
+	// base seed for sensor noise; picked at random unless given
+	uint32_t seed = 0;
+	bool seedGiven = false;
+
+	// no wall clock, keyboard or random seed anywhere, and a per-tick state
+	// hash; headless and batch only
+	bool deterministic = false;
+
+	// driver input script in place of the keyboard (see InputScript)
+	char const* inputPath = nullptr;
+
+	// golden hash trace to check against, and/or to write
+	char const* goldenPath = nullptr;
+	char const* recordGoldenPath = nullptr;
+
+	// ticks per recorded hash
+	int hashStride = 1;
+
+	// number of independent runs for a Monte Carlo batch, 0 for none
+	int batch = 0;
+
+	// worker threads for a batch, 0 for one per core
+	int threads = 0;
+
+	// number of bots for a world-less kinematics sweep, 0 for none
+	int sweep = 0;
+
+	// force the scalar kinematics path
+	bool noSimd = false;
+
+	// per-tick binary log for windowed and headless runs, nullptr for none
+	char const* logPath = "robosim.rslog";
+
+	// scrub through a log instead of simulating
+	char const* replayPath = nullptr;
+
+	// robot program library to run instead of the built-in one; reloaded
+	// on change when windowed
+	char const* robotPath = nullptr;
+
+	// shared memory name for an external robot process to attach to
+	char const* halName = nullptr;
+
+	// drive a physical tank chassis (motors, battery, tires) instead of the
+	// kinematic bot
+	bool drivetrain = false;
+
+	// play a full 3v3 match headless instead of the single-bot sim
+	bool match = false;
+
+	// field file for --match, compiled and cached next to itself; the
+	// built-in 2023 field when not given
+	char const* fieldPath = nullptr;
+
+	// lidar beams per robot in a match, 0 for no lidars, and scans per second
+	int lidarBeams = 0;
+	float lidarHz = 20.0f;
+
+	// AprilTag cameras per robot in a match, spread evenly around the
+	// chassis, and their latency in seconds
+	int cameras = 0;
+	float cameraLatency = 0.05f;
+
+	// compare the rlImGui render paths instead of simulating
+	bool imguiBench = false;
+	int benchFrames = 600;
+};
+
+// returns false (after printing usage) if the arguments don't make sense
+bool parseOptions(int argc, char** argv, Options& opts);
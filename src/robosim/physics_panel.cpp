@@ -0,0 +1,159 @@
+#include "physics_panel.hpp"
+
+#include <algorithm>
+#include <cfloat>
+
+#include "imgui.h"
+
+PhysicsPanel::PhysicsPanel(float budgetMs)
+	: history(kHistory)
+	, scratch(kHistory)
+	, sorted(kHistory)
+	, budgetMs(budgetMs)
+{
+	spikes.reserve(kSpikes);
+}
+
+void PhysicsPanel::publish(b2World const& world, b2Profile const& profile, double t) {
+	if (publishCount++ % kTreeStatsEvery == 0) {
+		treeBalance = world.GetTreeBalance();
+		treeQuality = world.GetTreeQuality();
+	}
+
+	ring.push({
+		t,
+		profile,
+		world.GetBodyCount(),
+		world.GetContactCount(),
+		world.GetProxyCount(),
+		world.GetTreeHeight(),
+		treeBalance,
+		treeQuality,
+	});
+}
+
+void PhysicsPanel::drain() {
+	PhysicsSample s;
+	while (ring.pop(s)) {
+		history[head] = s;
+		head = (head + 1) % kHistory;
+		count = std::min(count + 1, kHistory);
+		totalSteps++;
+
+		// the solver over budget on its own is what the panel is for; the
+		// whole step over (collide and broadphase too) is counted apart
+		bool solveOver = s.profile.solve > budgetMs;
+		bool stepOver = s.profile.step > budgetMs;
+		solveOverBudget += solveOver;
+		stepOverBudget += stepOver;
+		if (solveOver || stepOver) {
+			if (spikes.size() == kSpikes) {
+				spikes.erase(spikes.begin());
+			}
+			spikes.push_back(s);
+		}
+	}
+}
+
+namespace {
+
+struct Metric {
+	char const* name;
+	float b2Profile::*field;
+};
+
+Metric const metrics[] = {
+	{"step", &b2Profile::step},
+	{"collide", &b2Profile::collide},
+	{"solve", &b2Profile::solve},
+	{"solveInit", &b2Profile::solveInit},
+	{"solveVelocity", &b2Profile::solveVelocity},
+	{"solvePosition", &b2Profile::solvePosition},
+	{"broadphase", &b2Profile::broadphase},
+	{"solveTOI", &b2Profile::solveTOI},
+};
+
+// the phase that ate most of a step, for labeling spikes
+char const* worstPhase(b2Profile const& p) {
+	char const* name = "collide";
+	float worst = p.collide;
+	if (p.solve > worst) {
+		name = "solve";
+		worst = p.solve;
+	}
+	if (p.solveTOI > worst) {
+		name = "solveTOI";
+	}
+	return name;
+}
+
+}
+
+void PhysicsPanel::draw() {
+	ImGui::Begin("Physics");
+
+	if (count == 0) {
+		ImGui::Text("no steps yet");
+		ImGui::End();
+		return;
+	}
+
+	PhysicsSample const& latest = history[(head + kHistory - 1) % kHistory];
+	ImGui::Text("Bodies %d, contacts %d, proxies %d", latest.bodies, latest.contacts, latest.proxies);
+	ImGui::Text("Tree height %d, balance %d, quality %.3f", latest.treeHeight, latest.treeBalance, latest.treeQuality);
+	ImGui::Text("Budget %.3f ms/step: solve over in %lld of %lld steps (%.2f%%)", budgetMs, solveOverBudget, totalSteps, 100.0 * solveOverBudget / totalSteps);
+	ImGui::Text("Whole step over in %lld (%.2f%%)", stepOverBudget, 100.0 * stepOverBudget / totalSteps);
+
+	if (ImGui::BeginTable("b2Profile", 4, ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders)) {
+		ImGui::TableSetupColumn("Phase");
+		ImGui::TableSetupColumn("Avg ms");
+		ImGui::TableSetupColumn("p99 ms");
+		ImGui::TableSetupColumn("History");
+		ImGui::TableHeadersRow();
+
+		for (auto const& m : metrics) {
+			// oldest first, so the plot scrolls left
+			double sum = 0;
+			for (int i = 0; i < count; i++) {
+				float v = history[(head + kHistory - count + i) % kHistory].profile.*m.field;
+				scratch[i] = v;
+				sum += v;
+			}
+			float avg = static_cast<float>(sum / count);
+
+			std::copy(scratch.begin(), scratch.begin() + count, sorted.begin());
+			int p99 = std::min(count - 1, count * 99 / 100);
+			std::nth_element(sorted.begin(), sorted.begin() + p99, sorted.begin() + count);
+			float p99Value = sorted[p99];
+
+			ImGui::TableNextRow();
+			ImGui::TableNextColumn();
+			ImGui::TextUnformatted(m.name);
+			ImGui::TableNextColumn();
+			ImGui::Text("%.4f", avg);
+			ImGui::TableNextColumn();
+			if (p99Value > budgetMs) {
+				ImGui::TextColored({1, 0.4f, 0.4f, 1}, "%.4f", p99Value);
+			} else {
+				ImGui::Text("%.4f", p99Value);
+			}
+			ImGui::TableNextColumn();
+			ImGui::PushID(m.name);
+			ImGui::PlotLines("", scratch.data(), count, 0, nullptr, 0, FLT_MAX, {240, 30});
+			ImGui::PopID();
+		}
+		ImGui::EndTable();
+	}
+
+	if (!spikes.empty()) {
+		ImGui::Separator();
+		ImGui::TextColored({1, 0.4f, 0.4f, 1}, "Recent steps over budget:");
+		for (auto it = spikes.rbegin(); it != spikes.rend(); ++it) {
+			char const* what = it->profile.solve > budgetMs ? "solve over" : "step over";
+			ImGui::Text("t=%.2f s, %s: solve %.3f ms, step %.3f ms (mostly %s), %d bodies, %d contacts",
+				it->t, what, it->profile.solve, it->profile.step, worstPhase(it->profile), it->bodies, it->contacts);
+		}
+	}
+
+	ImGui::End();
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <vector>
+
+#include <box2d/box2d.h>
+
+#include "telemetry.hpp"
+
+// Box2D's own per-step numbers (b2Profile, in ms) plus broadphase stats,
+// as of one step.
+struct PhysicsSample {
+	double t;
+	b2Profile profile;
+	int32 bodies;
+	int32 contacts;
+	int32 proxies;
+	int32 treeHeight;
+	int32 treeBalance;
+	float treeQuality;
+};
+
+// Live physics performance panel. The sim thread publishes a sample after
+// every tick's b2World::Step (or steps, when it's substepped); the UI
+// drains them and shows rolling averages, p99, history plots, and which
+// ticks' solve (and, counted apart, whole step) went over the realtime
+// budget.
+class PhysicsPanel {
+public:
+	// budgetMs is how long a step may take and still keep up with realtime
+	explicit PhysicsPanel(float budgetMs);
+
+	// producer side, once the tick's stepping is done; profile is Box2D's,
+	// summed over the tick's substeps if there were several
+	void publish(b2World const& world, b2Profile const& profile, double t);
+
+	// consumer side, once a frame
+	void drain();
+	void draw();
+
+private:
+	static constexpr int kHistory = 600;
+	static constexpr int kSpikes = 8;
+
+	// walking the whole tree for balance and quality isn't free, so those
+	// are only refreshed every this many steps
+	static constexpr int kTreeStatsEvery = 16;
+
+	SpscRing<PhysicsSample> ring{1024};
+	int publishCount = 0;
+	int32 treeBalance = 0;
+	float treeQuality = 0;
+
+	std::vector<PhysicsSample> history;
+	int head = 0;
+	int count = 0;
+	long long totalSteps = 0;
+	long long solveOverBudget = 0;
+	long long stepOverBudget = 0;
+
+	std::vector<PhysicsSample> spikes;
+	std::vector<float> scratch;
+	std::vector<float> sorted;
+	float budgetMs;
+};
@@ -0,0 +1,222 @@
+#include "profiler.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+
+#include "imgui.h"
+
+#include "telemetry.hpp"
+
+std::atomic<bool> profilerOn{false};
+
+namespace {
+
+constexpr size_t kThreadRingEvents = 1 << 15;
+
+struct ThreadBuffer {
+	SpscRing<ProfileEvent> ring{kThreadRingEvents};
+	std::atomic<uint64_t> dropped{0};
+	std::string name;
+	int id;
+};
+
+// only touched when a thread records its first event and when the view
+// drains, never per event
+std::mutex buffersMutex;
+std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+
+thread_local ThreadBuffer* threadBuffer = nullptr;
+
+ThreadBuffer* registerThread() {
+	std::lock_guard<std::mutex> lock(buffersMutex);
+	auto buf = std::make_unique<ThreadBuffer>();
+	buf->id = static_cast<int>(buffers.size());
+	buf->name = "thread " + std::to_string(buf->id);
+	buffers.push_back(std::move(buf));
+	return buffers.back().get();
+}
+
+}
+
+uint64_t profilerNowNs() {
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void profilerSetThreadName(char const* name) {
+	if (!threadBuffer) {
+		threadBuffer = registerThread();
+	}
+	std::lock_guard<std::mutex> lock(buffersMutex);
+	threadBuffer->name = name;
+}
+
+void profilerRecord(char const* name, uint64_t startNs, uint64_t endNs) {
+	if (!threadBuffer) {
+		threadBuffer = registerThread();
+	}
+	if (!threadBuffer->ring.push({name, startNs, endNs})) {
+		threadBuffer->dropped.fetch_add(1, std::memory_order_relaxed);
+	}
+}
+
+ProfilerView::ZoneStats& ProfilerView::zone(char const* name) {
+	// the same literal in two translation units needn't share an address,
+	// so fall back to comparing the text
+	for (auto& z : zones) {
+		if (z.name == name || strcmp(z.name, name) == 0) {
+			return z;
+		}
+	}
+	zones.push_back({});
+	zones.back().name = name;
+	return zones.back();
+}
+
+void ProfilerView::endFrame() {
+	uint64_t now = profilerNowNs();
+	int slot = frame % kHistoryFrames;
+	frameMs[slot] = lastFrameNs ? (now - lastFrameNs) / 1e6f : 0;
+	lastFrameNs = now;
+
+	{
+		std::lock_guard<std::mutex> lock(buffersMutex);
+		for (auto& buf : buffers) {
+			ProfileEvent e;
+			while (buf->ring.pop(e)) {
+				ZoneStats& z = zone(e.name);
+				z.frameNs += e.endNs - e.startNs;
+				z.frameCalls++;
+				if (traceFramesLeft > 0) {
+					trace.push_back({e, buf->id});
+				}
+			}
+		}
+	}
+
+	for (auto& z : zones) {
+		z.ms[slot] = z.frameNs / 1e6f;
+		z.calls[slot] = z.frameCalls;
+		z.frameNs = 0;
+		z.frameCalls = 0;
+	}
+	frame++;
+
+	if (traceFramesLeft > 0 && --traceFramesLeft == 0) {
+		writeTrace();
+	}
+}
+
+void ProfilerView::startTrace(int frames, std::string path) {
+	trace.clear();
+	tracePath = std::move(path);
+	traceFramesLeft = frames;
+	traceStatus = "recording...";
+}
+
+void ProfilerView::writeTrace() {
+	FILE* f = fopen(tracePath.c_str(), "w");
+	if (!f) {
+		traceStatus = "couldn't open " + tracePath;
+		return;
+	}
+
+	fprintf(f, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+	{
+		std::lock_guard<std::mutex> lock(buffersMutex);
+		for (auto const& buf : buffers) {
+			fprintf(f, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}},\n", buf->id, buf->name.c_str());
+		}
+	}
+
+	uint64_t base = trace.empty() ? 0 : trace.front().event.startNs;
+	for (auto const& t : trace) {
+		base = std::min(base, t.event.startNs);
+	}
+	for (size_t i = 0; i < trace.size(); i++) {
+		auto const& t = trace[i];
+		fprintf(f, "{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}%s\n",
+			t.event.name, t.thread, (t.event.startNs - base) / 1e3, (t.event.endNs - t.event.startNs) / 1e3,
+			i + 1 < trace.size() ? "," : "");
+	}
+	fprintf(f, "]}\n");
+	fclose(f);
+
+	traceStatus = "wrote " + std::to_string(trace.size()) + " events to " + tracePath;
+	trace.clear();
+	trace.shrink_to_fit();
+}
+
+void ProfilerView::draw() {
+	ImGui::Begin("Profiler");
+
+	bool on = profilerOn.load(std::memory_order_relaxed);
+	if (ImGui::Checkbox("Enabled", &on)) {
+		profilerOn.store(on, std::memory_order_relaxed);
+	}
+	ImGui::SameLine();
+	if (ImGui::Button("Dump trace (120 frames)") && traceFramesLeft == 0) {
+		profilerOn.store(true, std::memory_order_relaxed);
+		startTrace(120, "robosim-trace.json");
+	}
+	if (!traceStatus.empty()) {
+		ImGui::TextDisabled("%s", traceStatus.c_str());
+	}
+
+	int n = std::min(frame, kHistoryFrames);
+	float frameAvg = 0;
+	for (int i = 0; i < n; i++) {
+		frameAvg += frameMs[i];
+	}
+	frameAvg = n ? frameAvg / n : 0;
+	ImGui::PlotLines("Frame (ms)", frameMs, kHistoryFrames, frame % kHistoryFrames, nullptr, 0, 40, {0, 50});
+
+	if (ImGui::BeginTable("zones", 5, ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders)) {
+		ImGui::TableSetupColumn("Zone");
+		ImGui::TableSetupColumn("Avg ms");
+		ImGui::TableSetupColumn("Max ms");
+		ImGui::TableSetupColumn("% frame");
+		ImGui::TableSetupColumn("Calls/frame");
+		ImGui::TableHeadersRow();
+
+		for (auto const& z : zones) {
+			float sum = 0, mx = 0;
+			int calls = 0;
+			for (int i = 0; i < n; i++) {
+				sum += z.ms[i];
+				mx = std::max(mx, z.ms[i]);
+				calls += z.calls[i];
+			}
+			float avg = n ? sum / n : 0;
+
+			ImGui::TableNextRow();
+			ImGui::TableNextColumn();
+			ImGui::TextUnformatted(z.name);
+			ImGui::TableNextColumn();
+			ImGui::Text("%.3f", avg);
+			ImGui::TableNextColumn();
+			ImGui::Text("%.3f", mx);
+			ImGui::TableNextColumn();
+			ImGui::Text("%.1f", frameAvg > 0 ? 100 * avg / frameAvg : 0);
+			ImGui::TableNextColumn();
+			ImGui::Text("%.1f", n ? calls / float(n) : 0);
+		}
+		ImGui::EndTable();
+	}
+
+	uint64_t dropped = 0;
+	{
+		std::lock_guard<std::mutex> lock(buffersMutex);
+		for (auto const& buf : buffers) {
+			dropped += buf->dropped.load(std::memory_order_relaxed);
+		}
+	}
+	if (dropped > 0) {
+		ImGui::TextDisabled("%llu events dropped", static_cast<unsigned long long>(dropped));
+	}
+
+	ImGui::End();
+}
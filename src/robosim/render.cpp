@@ -0,0 +1,353 @@
+#include "render.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include <raylib.h>
+
+#include "imgui.h"
+#include "raylib/Color.hpp"
+#include "b2DrawRayLib/b2DrawRayLib.hpp"
+
+void drawBot(Vector2 pos, float angle) {
+	DrawCircleV(pos, 20.0f, raylib::Color::Red());
+	DrawLineEx(pos, {pos.x + (20 * cosf(DEG2RAD * angle)), pos.y + (20 * sinf(DEG2RAD * angle))}, 3, BLACK);
+}
+
+void panZoomCamera(Camera2D& camera) {
+	if (IsKeyPressed(KEY_HOME)) {
+		camera = {{0, 0}, {0, 0}, 0, 1};
+	}
+	if (ImGui::GetIO().WantCaptureMouse) {
+		return;
+	}
+
+	if (IsMouseButtonDown(MOUSE_BUTTON_RIGHT)) {
+		Vector2 delta = GetMouseDelta();
+		camera.target.x -= delta.x / camera.zoom;
+		camera.target.y -= delta.y / camera.zoom;
+	}
+
+	float wheel = GetMouseWheelMove();
+	if (wheel != 0) {
+		// keep the point under the cursor where it is
+		Vector2 mouse = GetMousePosition();
+		camera.target = GetScreenToWorld2D(mouse, camera);
+		camera.offset = mouse;
+		camera.zoom *= wheel > 0 ? 1.25f : 0.8f;
+		camera.zoom = camera.zoom < 0.05f ? 0.05f : camera.zoom > 50 ? 50 : camera.zoom;
+	}
+}
+
+void captureRenderState(Sim const& sim, RenderState& state) {
+	state.bot = sim.bot;
+	state.bodies.clear();
+	for (b2Body const* b = sim.world.GetBodyList(); b; b = b->GetNext()) {
+		if (b->GetType() != b2_staticBody) {
+			state.bodies.push_back({b, b->GetTransform()});
+		}
+	}
+}
+
+void RenderGeometry::clear() {
+	bodies.clear();
+	shapes.clear();
+	vertices.clear();
+	aabbs.clear();
+}
+
+static float lerpAngle(float a, float b, float t) {
+	float diff = std::remainder(b - a, 2.0f * b2_pi);
+	return a + diff * t;
+}
+
+static b2Transform lerpTransform(b2Transform const& a, b2Transform const& b, float t) {
+	b2Transform xf;
+	xf.p = a.p + t * (b.p - a.p);
+	xf.q.Set(lerpAngle(a.q.GetAngle(), b.q.GetAngle(), t));
+	return xf;
+}
+
+// same palette b2World::DebugDraw uses
+static b2Color bodyColor(b2Body const* b) {
+	if (!b->IsEnabled()) return b2Color(0.5f, 0.5f, 0.3f);
+	if (b->GetType() == b2_staticBody) return b2Color(0.5f, 0.9f, 0.5f);
+	if (b->GetType() == b2_kinematicBody) return b2Color(0.5f, 0.5f, 0.9f);
+	if (!b->IsAwake()) return b2Color(0.6f, 0.6f, 0.6f);
+	return b2Color(0.9f, 0.7f, 0.7f);
+}
+
+static void captureFixture(b2Fixture const* f, RenderGeometry& frame) {
+	RenderShape shape{f->GetType(), f->GetShape()->m_radius, static_cast<int32>(frame.vertices.size()), 0, {}};
+	switch (f->GetType()) {
+	case b2Shape::e_circle: {
+		auto circle = static_cast<b2CircleShape const*>(f->GetShape());
+		frame.vertices.push_back(circle->m_p);
+		shape.vertexCount = 1;
+		break;
+	}
+	case b2Shape::e_polygon: {
+		auto poly = static_cast<b2PolygonShape const*>(f->GetShape());
+		frame.vertices.insert(frame.vertices.end(), poly->m_vertices, poly->m_vertices + poly->m_count);
+		shape.vertexCount = poly->m_count;
+		break;
+	}
+	case b2Shape::e_edge: {
+		auto edge = static_cast<b2EdgeShape const*>(f->GetShape());
+		frame.vertices.push_back(edge->m_vertex1);
+		frame.vertices.push_back(edge->m_vertex2);
+		shape.vertexCount = 2;
+		break;
+	}
+	case b2Shape::e_chain: {
+		auto chain = static_cast<b2ChainShape const*>(f->GetShape());
+		frame.vertices.insert(frame.vertices.end(), chain->m_vertices, chain->m_vertices + chain->m_count);
+		shape.vertexCount = chain->m_count;
+		break;
+	}
+	default:
+		break;
+	}
+	shape.bounds = f->GetAABB(0);
+	for (int32 i = 0; i < f->GetShape()->GetChildCount(); i++) {
+		b2AABB const& aabb = f->GetAABB(i);
+		shape.bounds.Combine(aabb);
+		frame.aabbs.push_back(aabb);
+	}
+	frame.shapes.push_back(shape);
+}
+
+// visible is sorted, or null to capture every fixture
+static void captureBody(b2Body const* b, b2Transform const& prevXf, std::vector<b2Fixture const*> const* visible, RenderGeometry& geometry) {
+	RenderBody body;
+	body.xf = b->GetTransform();
+	body.prevXf = prevXf;
+	body.localCenter = b->GetLocalCenter();
+	body.color = bodyColor(b);
+	body.firstShape = static_cast<int32>(geometry.shapes.size());
+	for (b2Fixture const* f = b->GetFixtureList(); f; f = f->GetNext()) {
+		if (!visible || std::binary_search(visible->begin(), visible->end(), f)) {
+			captureFixture(f, geometry);
+		}
+	}
+	body.shapeCount = static_cast<int32>(geometry.shapes.size()) - body.firstShape;
+	if (body.shapeCount > 0) {
+		geometry.bodies.push_back(body);
+	}
+}
+
+namespace {
+
+// collects the moving fixtures whose proxies overlap the query box
+struct VisibleFixtures : b2QueryCallback {
+	std::vector<b2Fixture const*>& out;
+
+	explicit VisibleFixtures(std::vector<b2Fixture const*>& out) : out(out) {}
+
+	bool ReportFixture(b2Fixture* fixture) override {
+		if (fixture->GetBody()->GetType() != b2_staticBody) {
+			out.push_back(fixture);
+		}
+		return true;
+	}
+};
+
+}
+
+static void hashCombine(uint64_t& h, uint64_t v) {
+	// FNV-1a over the value's bytes
+	for (int i = 0; i < 8; i++) {
+		h ^= (v >> (8 * i)) & 0xff;
+		h *= 0x100000001b3ull;
+	}
+}
+
+// changes when a static body or fixture comes or goes, or a static body is
+// moved or enabled/disabled; cheap next to copying the geometry
+static uint64_t staticSignature(b2World const& world) {
+	uint64_t h = 0xcbf29ce484222325ull;
+	for (b2Body const* b = world.GetBodyList(); b; b = b->GetNext()) {
+		if (b->GetType() != b2_staticBody) {
+			continue;
+		}
+		b2Transform const& xf = b->GetTransform();
+		uint32_t bits[4];
+		memcpy(bits, &xf.p, sizeof(xf.p));
+		memcpy(bits + 2, &xf.q.s, sizeof(float));
+		memcpy(bits + 3, &xf.q.c, sizeof(float));
+		hashCombine(h, reinterpret_cast<uintptr_t>(b));
+		hashCombine(h, (uint64_t)bits[0] << 32 | bits[1]);
+		hashCombine(h, (uint64_t)bits[2] << 32 | bits[3]);
+		hashCombine(h, b->IsEnabled());
+		for (b2Fixture const* f = b->GetFixtureList(); f; f = f->GetNext()) {
+			hashCombine(h, reinterpret_cast<uintptr_t>(f));
+		}
+	}
+	return h;
+}
+
+void captureRenderFrame(Sim const& sim, RenderState const& prev, b2AABB const* view, RenderCapture& capture, RenderFrame& frame) {
+	frame.time = sim.time();
+	frame.tick = sim.tick;
+	frame.physicsHz = sim.physicsHz;
+	frame.timeStep = sim.timeStep;
+	frame.bot = sim.bot;
+	frame.prevBot = prev.bot;
+	frame.err = sim.err();
+	frame.maxErr = sim.maxErr;
+
+	StaticGeometryCache& statics = capture.statics;
+	uint64_t signature = staticSignature(sim.world);
+	if (!statics.geometry || signature != statics.signature) {
+		// a fresh one rather than reusing: the render thread may still be
+		// drawing the old one
+		auto geometry = std::make_shared<RenderGeometry>();
+		for (b2Body const* b = sim.world.GetBodyList(); b; b = b->GetNext()) {
+			if (b->GetType() == b2_staticBody) {
+				captureBody(b, b->GetTransform(), nullptr, *geometry);
+			}
+		}
+		statics.geometry = std::move(geometry);
+		statics.signature = signature;
+		statics.version++;
+	}
+	frame.statics = statics.geometry;
+	frame.staticVersion = statics.version;
+
+	frame.dynamic.clear();
+	frame.culled = view != nullptr;
+	frame.view = view ? *view : b2AABB{};
+
+	// a chain reports once per child it has in view, hence the unique
+	std::vector<b2Fixture const*>* visible = nullptr;
+	if (view) {
+		capture.visible.clear();
+		VisibleFixtures query{capture.visible};
+		sim.world.QueryAABB(&query, *view);
+		std::sort(capture.visible.begin(), capture.visible.end());
+		capture.visible.erase(std::unique(capture.visible.begin(), capture.visible.end()), capture.visible.end());
+		visible = &capture.visible;
+	}
+
+	// bodies come and go, so match them up by pointer rather than position
+	size_t j = 0;
+	frame.fixtures = 0;
+	for (b2Body const* b = sim.world.GetBodyList(); b; b = b->GetNext()) {
+		if (b->GetType() == b2_staticBody) {
+			continue;
+		}
+		b2Transform prevXf = b->GetTransform();
+		if (j < prev.bodies.size() && prev.bodies[j].body == b) {
+			prevXf = prev.bodies[j].xf;
+			j++;
+		}
+		for (b2Fixture const* f = b->GetFixtureList(); f; f = f->GetNext()) {
+			frame.fixtures++;
+		}
+		captureBody(b, prevXf, visible, frame.dynamic);
+	}
+	frame.capturedFixtures = static_cast<int32>(frame.dynamic.shapes.size());
+}
+
+// view, when given, is only used to skip the off-screen segments of long
+// edges and chains; whole shapes are culled by the caller
+static void drawShape(RenderShape const& shape, b2Vec2 const* vertices, b2Transform const& xf, b2Color const& color, b2Draw& drawer, b2AABB const* view) {
+	switch (shape.type) {
+	case b2Shape::e_circle:
+		drawer.DrawSolidCircle(b2Mul(xf, vertices[0]), shape.radius, b2Mul(xf.q, b2Vec2(1, 0)), color);
+		break;
+	case b2Shape::e_polygon: {
+		b2Vec2 world[b2_maxPolygonVertices];
+		for (int32 i = 0; i < shape.vertexCount; i++) {
+			world[i] = b2Mul(xf, vertices[i]);
+		}
+		drawer.DrawSolidPolygon(world, shape.vertexCount, color);
+		break;
+	}
+	case b2Shape::e_edge:
+	case b2Shape::e_chain:
+		for (int32 i = 0; i + 1 < shape.vertexCount; i++) {
+			b2Vec2 a = b2Mul(xf, vertices[i]);
+			b2Vec2 b = b2Mul(xf, vertices[i + 1]);
+			if (view) {
+				b2AABB segment{b2Min(a, b), b2Max(a, b)};
+				if (!b2TestOverlap(segment, *view)) {
+					continue;
+				}
+			}
+			drawer.DrawSegment(a, b, color);
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+static void drawOverlays(RenderGeometry const& geometry, uint32 flags, b2Draw& drawer, b2AABB const* view) {
+	if (flags & b2Draw::e_aabbBit) {
+		b2Color color(0.9f, 0.3f, 0.9f);
+		for (b2AABB const& aabb : geometry.aabbs) {
+			if (view && !b2TestOverlap(aabb, *view)) {
+				continue;
+			}
+			b2Vec2 vs[4] = {
+				aabb.lowerBound,
+				{aabb.upperBound.x, aabb.lowerBound.y},
+				aabb.upperBound,
+				{aabb.lowerBound.x, aabb.upperBound.y},
+			};
+			drawer.DrawPolygon(vs, 4, color);
+		}
+	}
+
+	if (flags & b2Draw::e_centerOfMassBit) {
+		for (RenderBody const& body : geometry.bodies) {
+			b2Transform xf = body.xf;
+			xf.p = b2Mul(body.xf, body.localCenter);
+			drawer.DrawTransform(xf);
+		}
+	}
+}
+
+// only static geometry is culled here, since it doesn't move and its
+// bounds are exact; moving bodies were already culled when captured
+static void drawBodies(RenderGeometry const& geometry, float alpha, b2Draw& drawer, b2AABB const* view) {
+	for (RenderBody const& body : geometry.bodies) {
+		b2Transform xf = alpha >= 1 ? body.xf : lerpTransform(body.prevXf, body.xf, alpha);
+		for (int32 i = 0; i < body.shapeCount; i++) {
+			RenderShape const& shape = geometry.shapes[body.firstShape + i];
+			if (view && !b2TestOverlap(shape.bounds, *view)) {
+				continue;
+			}
+			drawShape(shape, &geometry.vertices[shape.firstVertex], xf, body.color, drawer, view);
+		}
+	}
+}
+
+void drawGeometry(RenderGeometry const& geometry, b2DrawRayLib& drawer, b2AABB const* view) {
+	uint32 flags = drawer.GetFlags();
+	if (flags & b2Draw::e_shapeBit) {
+		drawBodies(geometry, 1, drawer, view);
+	}
+	drawOverlays(geometry, flags, drawer, view);
+}
+
+void drawFrame(RenderFrame const& frame, float alpha, b2DrawRayLib& drawer, bool drawStatics) {
+	if (drawStatics && frame.statics) {
+		drawGeometry(*frame.statics, drawer, frame.culled ? &frame.view : nullptr);
+	}
+
+	Bot const& prevBot = frame.prevBot;
+	Vector2 botPos{
+		prevBot.pos.x + alpha * (frame.bot.pos.x - prevBot.pos.x),
+		prevBot.pos.y + alpha * (frame.bot.pos.y - prevBot.pos.y),
+	};
+	drawBot(botPos, prevBot.angle + alpha * (frame.bot.angle - prevBot.angle));
+
+	uint32 flags = drawer.GetFlags();
+	if (flags & b2Draw::e_shapeBit) {
+		drawBodies(frame.dynamic, alpha, drawer, nullptr);
+	}
+	drawOverlays(frame.dynamic, flags, drawer, nullptr);
+}
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <box2d/box2d.h>
+
+#include "sim.hpp"
+
+class b2DrawRayLib;
+
+struct BodyPose {
+	b2Body const* body;
+	b2Transform xf;
+};
+
+// the bits of a physics state the renderer needs to interpolate from;
+// static bodies never move, so they're left out
+struct RenderState {
+	Bot bot;
+	std::vector<BodyPose> bodies;
+};
+
+// one fixture's geometry in body-local coordinates. Circles keep their
+// center as their one vertex; polygons, edges and chains index a run of
+// RenderFrame::vertices.
+struct RenderShape {
+	b2Shape::Type type;
+	float radius;
+	int32 firstVertex;
+	int32 vertexCount;
+
+	// world space at the body's xf, covering every child
+	b2AABB bounds;
+};
+
+struct RenderBody {
+	b2Transform xf;
+
+	// as of the step before xf, or xf again for a body that's new this step
+	b2Transform prevXf;
+
+	b2Vec2 localCenter;
+	b2Color color;
+	int32 firstShape;
+	int32 shapeCount;
+};
+
+// bodies and their shapes, ready to draw
+struct RenderGeometry {
+	std::vector<RenderBody> bodies;
+	std::vector<RenderShape> shapes;
+	std::vector<b2Vec2> vertices;
+
+	// fixture AABBs in world space at xf, one per proxy
+	std::vector<b2AABB> aabbs;
+
+	void clear();
+};
+
+// Static bodies are captured once and shared by every frame until one is
+// added, removed or moved, instead of being copied every step.
+struct StaticGeometryCache {
+	uint64_t signature = 0;
+	uint64_t version = 0;
+	std::shared_ptr<RenderGeometry const> geometry;
+};
+
+// What the sim thread keeps between frames: the shared statics, plus
+// scratch space for culling so capturing doesn't allocate.
+struct RenderCapture {
+	StaticGeometryCache statics;
+	std::vector<b2Fixture const*> visible;
+};
+
+// A self-contained copy of everything drawn for one physics step. The sim
+// thread builds these and the render thread draws them without ever
+// touching the b2World. Vectors are cleared rather than freed between
+// uses, so a reused frame stops allocating once it has seen the scene.
+// Joints aren't captured; nothing in the sim makes any.
+struct RenderFrame {
+	// steady clock time the frame was published, for interpolation
+	uint64_t publishedNs = 0;
+
+	double time = 0;
+	int64_t tick = 0;
+	int physicsHz = 0;
+	float timeStep = 0;
+
+	Bot bot{};
+	Bot prevBot{};
+	float err = 0;
+	float maxErr = 0;
+
+	// everything that isn't static, and when culled, only the fixtures
+	// the broadphase found inside view
+	RenderGeometry dynamic;
+	bool culled = false;
+	b2AABB view{};
+	int32 fixtures = 0;
+	int32 capturedFixtures = 0;
+
+	// bumps whenever statics changes
+	uint64_t staticVersion = 0;
+	std::shared_ptr<RenderGeometry const> statics;
+
+	// snapshot status, so the UI never has to ask the sim thread
+	bool haveSnapshot = false;
+	size_t snapshotBytes = 0;
+	float captureUs = 0;
+	float restoreUs = 0;
+	bool restoreFailed = false;
+
+	// how many times the robot program was reloaded, -1 for the built-in one
+	int programReloads = -1;
+
+	// HAL bridge status, when there is one
+	bool hal = false;
+	bool halAttached = false;
+	double halMeanUs = 0;
+	double halMaxUs = 0;
+};
+
+// the red circle with a heading tick
+void drawBot(Vector2 pos, float angle);
+
+// mouse wheel zooms about the cursor, right drag pans, Home resets. Leaves
+// the camera alone while ImGui wants the mouse.
+void panZoomCamera(Camera2D& camera);
+
+void captureRenderState(Sim const& sim, RenderState& state);
+
+// fills frame from the sim's current state, with prev as the state one
+// step earlier. Static geometry is only recaptured into the cache when it
+// changed. With a view (in meters), moving fixtures are found with a
+// broadphase query and anything outside it is left out of the frame.
+void captureRenderFrame(Sim const& sim, RenderState const& prev, b2AABB const* view, RenderCapture& capture, RenderFrame& frame);
+
+// draws geometry as-is, with whichever of shapes, AABBs and centers of
+// mass the drawer's flags ask for, skipping anything outside view if given
+void drawGeometry(RenderGeometry const& geometry, b2DrawRayLib& drawer, b2AABB const* view = nullptr);
+
+// draws the bot and every moving body blended alpha of the way from the
+// frame's previous state to its current one, plus whichever overlays the
+// drawer's flags ask for (AABBs and centers of mass draw at the current
+// state). Statics are included unless a StaticLayer is drawing them.
+void drawFrame(RenderFrame const& frame, float alpha, b2DrawRayLib& drawer, bool drawStatics = true);
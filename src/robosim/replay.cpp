@@ -0,0 +1,110 @@
+#include "replay.hpp"
+
+#include <algorithm>
+#include <cstdio>
+
+#include <raylib.h>
+
+#include "raylib/raylib-cpp.hpp"
+#include "rlImGui/rlImGui.h"
+#include "imgui.h"
+
+#include "render.hpp"
+#include "sim.hpp"
+#include "simlog.hpp"
+
+// how much path to draw behind the bot
+constexpr float kTrailSeconds = 5.0f;
+constexpr int kTrailPoints = 200;
+
+int runReplay(Options const& opts) {
+	LogReader log;
+	if (!log.open(opts.replayPath)) {
+		return 1;
+	}
+	if (log.size() == 0) {
+		fprintf(stderr, "%s: empty log\n", opts.replayPath);
+		return 1;
+	}
+
+	int screenWidth = kFieldWidth;
+	int screenHeight = kFieldHeight;
+
+	raylib::Window window(screenWidth, screenHeight, "robosim - replay");
+	SetTargetFPS(60);
+	rlImGuiSetup(true);
+
+	double hz = log.physicsHz();
+	int64_t last = log.size() - 1;
+	double cursor = 0;
+	bool playing = true;
+	float speed = 1.0f;
+
+	while (!window.ShouldClose()) {
+		if (playing) {
+			cursor = std::min<double>(cursor + GetFrameTime() * hz * speed, last);
+			if (cursor >= last) {
+				playing = false;
+			}
+		}
+
+		// cursor is a record index; a record's own tick can differ from it
+		// (it's stamped after the step, and a snapshot restore rewinds it
+		// while the log keeps appending), so everything here goes by index
+		int64_t index = static_cast<int64_t>(cursor);
+		LogRecord const& r = log.at(index);
+
+		BeginDrawing();
+		window.ClearBackground(RAYWHITE);
+
+		// trail: a fixed number of samples however long the window is, so
+		// this is O(1) in the length of the log too
+		int64_t trailTicks = static_cast<int64_t>(kTrailSeconds * hz);
+		int64_t stride = std::max<int64_t>(1, trailTicks / kTrailPoints);
+		for (int64_t t = std::max<int64_t>(0, index - trailTicks); t + stride <= index; t += stride) {
+			LogRecord const& a = log.at(t);
+			LogRecord const& b = log.at(t + stride);
+			DrawLineV({a.posX, a.posY}, {b.posX, b.posY}, GRAY);
+		}
+		DrawCircleV({r.sensedPosX, r.sensedPosY}, 4.0f, BLUE);
+		drawBot({r.posX, r.posY}, r.angle);
+
+		{
+			rlImGuiBegin();
+
+			ImGui::Begin("Replay");
+			ImGui::Text("%s (seed %u, %u Hz)", opts.replayPath, log.seed(), log.physicsHz());
+
+			int record = static_cast<int>(index);
+			if (ImGui::SliderInt("Record", &record, 0, static_cast<int>(last))) {
+				cursor = record;
+			}
+			ImGui::Text("Time: %.3f s / %.3f s (sim tick %lld)", index / hz, last / hz, static_cast<long long>(r.tick));
+			if (ImGui::Button(playing ? "Pause" : "Play")) {
+				if (!playing && cursor >= last) {
+					cursor = 0;
+				}
+				playing = !playing;
+			}
+			ImGui::SameLine();
+			ImGui::SliderFloat("Speed", &speed, 0.1f, 10.0f, "%.1fx", ImGuiSliderFlags_Logarithmic);
+
+			ImGui::Separator();
+			ImGui::Text("Velocity: %f (sensed %f)", r.vel, r.sensedVel);
+			ImGui::Text("Angle: %f (sensed %f)", r.angle, r.sensedAngle);
+			ImGui::Text("Position: (%f, %f)", r.posX, r.posY);
+			ImGui::Text("Sensed:   (%f, %f)", r.sensedPosX, r.sensedPosY);
+			ImGui::Text("Command: dVel %f, dAngle %f", r.cmdVel, r.cmdAngle);
+			ImGui::Text("Err: %f", r.err);
+			ImGui::Text("Input: %s%s%s%s", r.input & 1 ? "L " : "", r.input & 2 ? "R " : "", r.input & 4 ? "U " : "", r.input & 8 ? "D" : "");
+			ImGui::End();
+
+			rlImGuiEnd();
+		}
+
+		EndDrawing();
+	}
+
+	rlImGuiShutdown();
+	return 0;
+}
@@ -0,0 +1,6 @@
+#pragma once
+
+#include "options.hpp"
+
+// maps opts.replayPath and lets you scrub through it with a timeline
+int runReplay(Options const& opts);
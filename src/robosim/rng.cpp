@@ -0,0 +1,61 @@
+#include "rng.hpp"
+
+#include <cmath>
+#include <cstdio>
+
+// maps to (0, 1) so the log below never sees zero
+static float uniform(uint32_t x) {
+	return (x >> 8) * 0x1p-24f + 0x1p-25f;
+}
+
+std::array<float, 4> gaussian4(PhiloxCounter ctr, PhiloxKey key) {
+	PhiloxCounter bits = philox(ctr, key);
+
+	float r0 = std::sqrt(-2.0f * std::log(uniform(bits[0])));
+	float t0 = 6.28318530718f * uniform(bits[1]);
+	float r1 = std::sqrt(-2.0f * std::log(uniform(bits[2])));
+	float t1 = 6.28318530718f * uniform(bits[3]);
+
+	return {r0 * std::cos(t0), r0 * std::sin(t0), r1 * std::cos(t1), r1 * std::sin(t1)};
+}
+
+void fillGaussian(float* out, size_t n, PhiloxCounter ctr, PhiloxKey key) {
+	size_t i = 0;
+	for (; i + 4 <= n; i += 4) {
+		auto g = gaussian4(ctr, key);
+		out[i] = g[0];
+		out[i + 1] = g[1];
+		out[i + 2] = g[2];
+		out[i + 3] = g[3];
+		ctr[3]++;
+	}
+	if (i < n) {
+		auto g = gaussian4(ctr, key);
+		for (size_t j = 0; i < n; i++, j++) {
+			out[i] = g[j];
+		}
+	}
+}
+
+bool philoxSelfTest() {
+	struct Vector {
+		PhiloxCounter ctr;
+		PhiloxKey key;
+		PhiloxCounter expected;
+	};
+	// kat_vectors from the Random123 distribution
+	static Vector const vectors[] = {
+		{{0, 0, 0, 0}, {0, 0}, {0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}},
+		{{0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}, {0xffffffff, 0xffffffff}, {0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}},
+		{{0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}, {0xa4093822, 0x299f31d0}, {0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}},
+	};
+	for (Vector const& v : vectors) {
+		PhiloxCounter got = philox(v.ctr, v.key);
+		if (got != v.expected) {
+			fprintf(stderr, "philox self-test failed: got %08x %08x %08x %08x, expected %08x %08x %08x %08x\n",
+				got[0], got[1], got[2], got[3], v.expected[0], v.expected[1], v.expected[2], v.expected[3]);
+			return false;
+		}
+	}
+	return true;
+}
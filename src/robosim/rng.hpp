@@ -0,0 +1,41 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Philox4x32-10 (Salmon et al., "Parallel random numbers: as easy as 1, 2,
+// 3"). There's no generator state: the output is a pure function of a
+// 128-bit counter and a 64-bit key, so any sample can be recomputed from
+// where it sits in the run, and threads never share anything.
+using PhiloxCounter = std::array<uint32_t, 4>;
+using PhiloxKey = std::array<uint32_t, 2>;
+
+inline PhiloxCounter philox(PhiloxCounter ctr, PhiloxKey key) {
+	for (int round = 0; round < 10; round++) {
+		uint64_t p0 = static_cast<uint64_t>(0xD2511F53u) * ctr[0];
+		uint64_t p1 = static_cast<uint64_t>(0xCD9E8D57u) * ctr[2];
+		ctr = {
+			static_cast<uint32_t>(p1 >> 32) ^ ctr[1] ^ key[0],
+			static_cast<uint32_t>(p1),
+			static_cast<uint32_t>(p0 >> 32) ^ ctr[3] ^ key[1],
+			static_cast<uint32_t>(p0),
+		};
+		key[0] += 0x9E3779B9u;
+		key[1] += 0xBB67AE85u;
+	}
+	return ctr;
+}
+
+// four independent standard normals from one philox block (Box-Muller)
+std::array<float, 4> gaussian4(PhiloxCounter ctr, PhiloxKey key);
+
+// fills out[0..n) with standard normals from consecutive counters starting
+// at ctr, four samples per philox call. Word 3 counts up: callers put the
+// tick in words 0 and 1, so counting there would repeat the next tick's
+// noise.
+void fillGaussian(float* out, size_t n, PhiloxCounter ctr, PhiloxKey key);
+
+// checks philox() against Random123's known-answer vectors for
+// Philox4x32-10; prints the first mismatch and returns false
+bool philoxSelfTest();
@@ -0,0 +1,29 @@
+#include "robot.hpp"
+
+#include <cmath>
+
+#include "sim.hpp"
+
+void periodic(Bot& bot, DriverInput const& input) {
+	// gains were tuned per 60 fps frame, so scale them to the 20 ms loop
+	float k = kRobotPeriod * kTuningRate;
+	float turn = k * (2.0f - std::abs(bot.vel / 2));
+
+	// lets try to drive straight, naively
+
+	if (bot.getVel() < 2) {
+		bot.vel += k * 0.06f;
+	}
+
+	if (bot.getPos().y > kFieldHeight / 2) {
+		bot.angle -= turn;
+	} else {
+		bot.angle += turn;
+	}
+
+	if (input.left) bot.angle -= turn;
+	if (input.right) bot.angle += turn;
+
+	if (input.up) bot.vel += k * 0.06f;
+	if (input.down) bot.vel -= k * 0.06f;
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+struct Bot;
+struct DriverInput;
+
+// FRC's robot loop runs every 20 ms, independent of the physics rate
+constexpr int kRobotHz = 50;
+constexpr float kRobotPeriod = 1.0f / kRobotHz;
+
+// the robot program, called once per robot loop by the sim
+void periodic(Bot& bot, DriverInput const& input);
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <stdint.h>
+
+// The interface between the sim and a robot program built as a shared
+// library (see robot/ at the top of the repo). Plain C types only, so the
+// library doesn't need raylib or Box2D and any compiler's build loads into
+// any build of the sim. Bump the version whenever these structs change.
+#define ROBOT_ABI_VERSION 3
+
+#ifdef _WIN32
+#define ROBOT_EXPORT extern "C" __declspec(dllexport)
+#else
+#define ROBOT_EXPORT extern "C" __attribute__((visibility("default")))
+#endif
+
+struct RobotContext {
+	uint32_t abiVersion;
+
+	// seconds between robotPeriodic calls
+	float period;
+
+	// where the bot lives, in pixels
+	float fieldWidth;
+	float fieldHeight;
+
+	// the rate the original per-frame gains were tuned at
+	float tuningRate;
+
+	// nonzero when robotInit is called for a reload rather than a fresh start
+	int reloaded;
+
+	// belongs to the program and outlives reloads: anything kept here
+	// (integrators, state machines) carries over to the new build. Aligned
+	// to 16, enough for any program state struct to live at its start.
+	alignas(16) unsigned char memory[4096];
+};
+
+// most tag sightings one loop is handed; past this the rest are dropped
+#define ROBOT_MAX_SIGHTINGS 16
+
+// an AprilTag one of the bot's cameras saw, relative to that camera,
+// noise included
+struct RobotTagSighting {
+	int32_t tag;         // the field's tag id
+	int32_t camera;      // which of the bot's cameras, in mount order
+	double captureTime;  // s; when the frame was exposed, a latency ago
+	float range;         // m, lens to tag across the floor
+	float bearing;       // radians, counterclockwise from the camera's axis
+	float yaw;           // radians, the tag's facing relative to the camera's
+};
+
+// one robot loop's worth of inputs and outputs
+struct RobotLoopIo {
+	double time;
+
+	// sensor readings, noise included
+	float sensedAngle;
+	float sensedVel;
+	float sensedPosX;
+	float sensedPosY;
+
+	// the drivetrain's commanded heading (degrees) and speed; the program
+	// changes these in place
+	float angle;
+	float vel;
+
+	// driver station buttons
+	uint8_t left;
+	uint8_t right;
+	uint8_t up;
+	uint8_t down;
+
+	// sightings from camera frames that came through their latency since
+	// the last loop; none when the bot has no cameras
+	uint32_t sightingCount;
+	RobotTagSighting sightings[ROBOT_MAX_SIGHTINGS];
+};
+
+// called after every load, fresh or reload; nonzero rejects the build
+typedef int (*RobotInitFn)(RobotContext* ctx);
+
+typedef void (*RobotPeriodicFn)(RobotContext* ctx, RobotLoopIo* io);
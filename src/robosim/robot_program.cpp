@@ -0,0 +1,206 @@
+#include "robot_program.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <system_error>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#include <unistd.h>
+#endif
+
+#include "robot.hpp"
+#include "sim.hpp"
+
+namespace fs = std::filesystem;
+using clock_type = std::chrono::steady_clock;
+
+// how often poll() looks at the file, and how long it must sit unchanged
+// before it's loaded
+constexpr auto kCheckInterval = std::chrono::milliseconds(250);
+constexpr auto kSettleTime = std::chrono::milliseconds(200);
+
+#ifdef _WIN32
+
+static void* openLibrary(fs::path const& p) {
+	return LoadLibraryW(p.c_str());
+}
+
+static void* findSymbol(void* lib, char const* name) {
+	return reinterpret_cast<void*>(GetProcAddress(static_cast<HMODULE>(lib), name));
+}
+
+static void closeLibrary(void* lib) {
+	FreeLibrary(static_cast<HMODULE>(lib));
+}
+
+static std::string libraryError() {
+	return "error " + std::to_string(GetLastError());
+}
+
+static unsigned long processId() {
+	return GetCurrentProcessId();
+}
+
+#else
+
+static void* openLibrary(fs::path const& p) {
+	return dlopen(p.c_str(), RTLD_NOW | RTLD_LOCAL);
+}
+
+static void* findSymbol(void* lib, char const* name) {
+	return dlsym(lib, name);
+}
+
+static void closeLibrary(void* lib) {
+	dlclose(lib);
+}
+
+static std::string libraryError() {
+	char const* err = dlerror();
+	return err ? err : "unknown error";
+}
+
+static unsigned long processId() {
+	return static_cast<unsigned long>(getpid());
+}
+
+#endif
+
+RobotProgram::RobotProgram() {
+	memset(&ctx, 0, sizeof(ctx));
+	ctx.abiVersion = ROBOT_ABI_VERSION;
+	ctx.period = kRobotPeriod;
+	ctx.fieldWidth = kFieldWidth;
+	ctx.fieldHeight = kFieldHeight;
+	ctx.tuningRate = kTuningRate;
+}
+
+RobotProgram::~RobotProgram() {
+	unloadLibrary();
+}
+
+bool RobotProgram::load(char const* p) {
+	path = p;
+	std::error_code ec;
+	loadedTime = fs::last_write_time(path, ec);
+	if (ec) {
+		fprintf(stderr, "can't read robot program %s: %s\n", p, ec.message().c_str());
+		return false;
+	}
+	nextCheck = clock_type::now() + kCheckInterval;
+	return loadLibrary(false);
+}
+
+bool RobotProgram::poll() {
+	if (path.empty()) {
+		return false;
+	}
+	auto now = clock_type::now();
+	if (now < nextCheck) {
+		return false;
+	}
+	nextCheck = now + kCheckInterval;
+
+	// missing for a moment is normal while the linker replaces it
+	std::error_code ec;
+	auto mtime = fs::last_write_time(path, ec);
+	if (ec || mtime == loadedTime) {
+		pending = false;
+		return false;
+	}
+	if (!pending || mtime != pendingTime) {
+		pending = true;
+		pendingTime = mtime;
+		pendingSince = now;
+		return false;
+	}
+	if (now - pendingSince < kSettleTime) {
+		return false;
+	}
+
+	pending = false;
+	// whether or not it loads, don't try this build again
+	loadedTime = mtime;
+	if (!loadLibrary(true)) {
+		return false;
+	}
+	reloadCount++;
+	printf("reloaded robot program %s (reload %d)\n", path.string().c_str(), reloadCount);
+	return true;
+}
+
+bool RobotProgram::loadLibrary(bool reloading) {
+	fs::path copy = fs::temp_directory_path()
+		/ ("robosim-robot-" + std::to_string(processId()) + "-" + std::to_string(loadCount++) + path.extension().string());
+	std::error_code ec;
+	fs::copy_file(path, copy, fs::copy_options::overwrite_existing, ec);
+	if (ec) {
+		fprintf(stderr, "can't copy robot program %s: %s\n", path.string().c_str(), ec.message().c_str());
+		return false;
+	}
+
+	void* lib = openLibrary(copy);
+	if (!lib) {
+		fprintf(stderr, "can't load robot program %s: %s\n", path.string().c_str(), libraryError().c_str());
+		fs::remove(copy, ec);
+		return false;
+	}
+
+	auto init = reinterpret_cast<RobotInitFn>(findSymbol(lib, "robotInit"));
+	auto periodic = reinterpret_cast<RobotPeriodicFn>(findSymbol(lib, "robotPeriodic"));
+	if (!init || !periodic) {
+		fprintf(stderr, "robot program %s doesn't export robotInit and robotPeriodic\n", path.string().c_str());
+		closeLibrary(lib);
+		fs::remove(copy, ec);
+		return false;
+	}
+
+	// init may scribble on ctx before rejecting itself; the old build
+	// mustn't see that
+	RobotContext saved = ctx;
+	ctx.reloaded = reloading;
+	int status = init(&ctx);
+	if (status != 0) {
+		fprintf(stderr, "robot program %s failed to init (%d)\n", path.string().c_str(), status);
+		ctx = saved;
+		closeLibrary(lib);
+		fs::remove(copy, ec);
+		return false;
+	}
+
+	unloadLibrary();
+	library = lib;
+	libraryCopy = copy;
+	periodicFn = periodic;
+
+#ifndef _WIN32
+	// it's mapped now; the name can go
+	fs::remove(libraryCopy, ec);
+	libraryCopy.clear();
+#endif
+	return true;
+}
+
+void RobotProgram::unloadLibrary() {
+	if (library) {
+		closeLibrary(library);
+		library = nullptr;
+		periodicFn = nullptr;
+	}
+	if (!libraryCopy.empty()) {
+		std::error_code ec;
+		fs::remove(libraryCopy, ec);
+		libraryCopy.clear();
+	}
+}
+
+void RobotProgram::periodic(RobotLoopIo& io) {
+	if (periodicFn) {
+		periodicFn(&ctx, &io);
+	}
+}
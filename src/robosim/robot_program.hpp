@@ -0,0 +1,59 @@
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <string>
+
+#include "robot_abi.hpp"
+
+// A robot program loaded from a shared library exporting robotInit and
+// robotPeriodic, reloaded whenever the file changes. The sim's own state
+// lives outside the library and the program's lives in ctx.memory, so a
+// reload picks up exactly where the old build left off.
+//
+// Each build is copied aside before loading, so the compiler is free to
+// overwrite the original while the old copy is still running. A build
+// that fails to load or init is reported and skipped, and the previous one
+// keeps running.
+class RobotProgram {
+public:
+	RobotProgram();
+	~RobotProgram();
+
+	RobotProgram(RobotProgram const&) = delete;
+	RobotProgram& operator=(RobotProgram const&) = delete;
+
+	// loads path for the first time; prints why and returns false on failure
+	bool load(char const* path);
+
+	// cheap enough to call every tick: checks the file at most a few times a
+	// second and reloads once a change has settled. Returns true on reload.
+	bool poll();
+
+	void periodic(RobotLoopIo& io);
+
+	bool loaded() const { return library != nullptr; }
+	int reloads() const { return reloadCount; }
+
+	RobotContext ctx;
+
+private:
+	bool loadLibrary(bool reloading);
+	void unloadLibrary();
+
+	std::filesystem::path path;
+	std::filesystem::file_time_type loadedTime{};
+
+	// a change is only acted on once the file stops changing, so a
+	// half-written library never gets loaded
+	std::filesystem::file_time_type pendingTime{};
+	std::chrono::steady_clock::time_point pendingSince{};
+	std::chrono::steady_clock::time_point nextCheck{};
+	bool pending = false;
+
+	void* library = nullptr;
+	std::filesystem::path libraryCopy;
+	RobotPeriodicFn periodicFn = nullptr;
+	int loadCount = 0;
+	int reloadCount = 0;
+};
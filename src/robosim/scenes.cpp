@@ -0,0 +1,146 @@
+#include "scenes.hpp"
+
+#include <cmath>
+
+#include "rng.hpp"
+
+SceneSpec const kBenchScenes[] = {
+	{"empty field", 0, 0, false, 0},
+	{"6 drivetrains", 6, 0, false, 0},
+	{"6 drivetrains + 100 pieces", 6, 100, false, 0},
+	{"6 drivetrains + 500 pieces", 6, 500, false, 0},
+	{"6 drivetrains + 2000 pieces", 6, 2000, false, 0},
+	{"6 drivetrains + 500 packed pieces", 6, 500, true, 0},
+	{"6 drivetrains + 1000 respawning pieces", 6, 1000, false, 1000},
+};
+int const kBenchSceneCount = sizeof(kBenchScenes) / sizeof(kBenchScenes[0]);
+
+b2Body* addFieldWalls(b2World& world, float length, float width) {
+	b2BodyDef def;
+	b2Body* walls = world.CreateBody(&def);
+
+	b2Vec2 corners[4] = {
+		{0, 0},
+		{length, 0},
+		{length, width},
+		{0, width},
+	};
+	b2ChainShape chain;
+	chain.CreateLoop(corners, 4);
+	walls->CreateFixture(&chain, 0.0f);
+	return walls;
+}
+
+b2Body* addDrivetrain(b2World& world, b2Vec2 pos, float angle) {
+	b2BodyDef def;
+	def.type = b2_dynamicBody;
+	def.position = pos;
+	def.angle = angle;
+	def.linearDamping = 2.0f;
+	def.angularDamping = 4.0f;
+	b2Body* body = world.CreateBody(&def);
+
+	b2PolygonShape box;
+	box.SetAsBox(kDrivetrainSize / 2, kDrivetrainSize / 2);
+	b2FixtureDef fixture;
+	fixture.shape = &box;
+	// ~55 kg with bumpers
+	fixture.density = 55.0f / (kDrivetrainSize * kDrivetrainSize);
+	fixture.friction = 0.6f;
+	fixture.restitution = 0.1f;
+	body->CreateFixture(&fixture);
+	return body;
+}
+
+b2Body* addGamePiece(b2World& world, b2Vec2 pos, b2Vec2 vel) {
+	b2BodyDef def;
+	def.type = b2_dynamicBody;
+	def.position = pos;
+	def.linearVelocity = vel;
+	def.linearDamping = 0.8f;
+	def.angularDamping = 0.8f;
+	b2Body* body = world.CreateBody(&def);
+
+	b2CircleShape circle;
+	circle.m_radius = kGamePieceRadius;
+	b2FixtureDef fixture;
+	fixture.shape = &circle;
+	// ~0.27 kg, like a cargo ball
+	fixture.density = 0.27f / (b2_pi * kGamePieceRadius * kGamePieceRadius);
+	fixture.friction = 0.4f;
+	fixture.restitution = 0.5f;
+	body->CreateFixture(&fixture);
+	return body;
+}
+
+// a random spot on the field and a push, from one philox block
+static void scatter(PhiloxCounter ctr, PhiloxKey key, b2Vec2& pos, b2Vec2& vel) {
+	auto bits = philox(ctr, key);
+	float u[4];
+	for (int j = 0; j < 4; j++) {
+		u[j] = (bits[j] >> 8) * 0x1p-24f;
+	}
+	pos.x = 0.5f + u[0] * (kFieldLengthM - 1.0f);
+	pos.y = 0.5f + u[1] * (kFieldWidthM - 1.0f);
+	vel.x = (u[2] - 0.5f) * 4.0f;
+	vel.y = (u[3] - 0.5f) * 4.0f;
+}
+
+Scene buildScene(SceneSpec const& spec, uint32_t seed) {
+	Scene scene;
+	scene.world = std::make_unique<b2World>(b2Vec2(0, 0));
+	b2World& world = *scene.world;
+
+	addFieldWalls(world);
+
+	// three per alliance, lined up at each end facing the middle
+	for (int i = 0; i < spec.drivetrains; i++) {
+		bool red = i % 2 == 1;
+		float x = red ? kFieldLengthM - 2.0f : 2.0f;
+		float y = kFieldWidthM * (1 + i / 2) / 4.0f;
+		scene.drivetrains.push_back(addDrivetrain(world, {x, y}, red ? b2_pi : 0));
+	}
+
+	scene.key = {seed, 0x5ce7e};
+	scene.respawnsPerStep = spec.respawnsPerStep;
+	scene.gamePieces.reserve(world, spec.gamePieces);
+	float const spacing = 2 * kGamePieceRadius;
+	int perRow = static_cast<int>((kFieldWidthM - 0.5f) / spacing);
+	for (int i = 0; i < spec.gamePieces; i++) {
+		b2Vec2 pos;
+		b2Vec2 vel{0, 0};
+		if (spec.packed) {
+			// hex packing from the corner, each piece just touching its
+			// neighbours
+			int row = i / perRow;
+			int col = i % perRow;
+			pos.x = kGamePieceRadius + 0.01f + row * spacing * 0.866f;
+			pos.y = kGamePieceRadius + 0.01f + col * spacing + (row % 2) * kGamePieceRadius;
+		} else {
+			scatter({static_cast<uint32_t>(i), 0, 0, 0}, scene.key, pos, vel);
+		}
+		scene.gamePieces.spawn(pos, vel);
+	}
+
+	return scene;
+}
+
+void driveScene(Scene& scene, double t) {
+	for (size_t i = 0; i < scene.drivetrains.size(); i++) {
+		b2Body* b = scene.drivetrains[i];
+		float phase = static_cast<float>(t * 0.7 + i);
+		b2Vec2 heading = b->GetWorldVector({1, 0});
+		b->ApplyForceToCenter(600.0f * heading, true);
+		b->ApplyTorque(120.0f * std::sin(phase), true);
+	}
+
+	// oldest first, each straight back out of the pool somewhere new
+	GamePiecePool& pool = scene.gamePieces;
+	for (int i = 0; i < scene.respawnsPerStep && pool.capacity() > 0; i++) {
+		pool.despawn(pool.pieces()[scene.respawns % pool.capacity()]);
+		b2Vec2 pos, vel;
+		scatter({scene.respawns, 1, 0, 0}, scene.key, pos, vel);
+		pool.spawn(pos, vel);
+		scene.respawns++;
+	}
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <box2d/box2d.h>
+
+#include "game_pieces.hpp"
+#include "rng.hpp"
+
+// Canonical top-down FRC field scenes, in meters with no gravity (the
+// floor's friction is modeled as damping). Built the same way every time
+// for a given seed, so benchmarks can be compared release to release.
+
+// 2023 field, wall to wall
+constexpr float kFieldLengthM = 16.54f;
+constexpr float kFieldWidthM = 8.21f;
+
+constexpr float kDrivetrainSize = 0.9f;
+constexpr float kGamePieceRadius = 0.12f;
+
+struct SceneSpec {
+	char const* name;
+	int drivetrains;
+	int gamePieces;
+
+	// pieces jammed together in one corner, touching each other and the
+	// walls, instead of scattered and moving
+	bool packed;
+
+	// pieces taken out of play and put back somewhere else every step, to
+	// measure spawn/despawn churn
+	int respawnsPerStep;
+};
+
+extern SceneSpec const kBenchScenes[];
+extern int const kBenchSceneCount;
+
+struct Scene {
+	std::unique_ptr<b2World> world;
+	std::vector<b2Body*> drivetrains;
+	GamePiecePool gamePieces;
+
+	int respawnsPerStep = 0;
+	uint32_t respawns = 0;
+	PhiloxKey key{};
+};
+
+// perimeter walls as one static chain loop, corner at the origin
+b2Body* addFieldWalls(b2World& world, float length = kFieldLengthM, float width = kFieldWidthM);
+
+b2Body* addDrivetrain(b2World& world, b2Vec2 pos, float angle);
+b2Body* addGamePiece(b2World& world, b2Vec2 pos, b2Vec2 vel);
+
+Scene buildScene(SceneSpec const& spec, uint32_t seed);
+
+// pushes every drivetrain around a little, deterministically, so there's
+// always something colliding, and respawns pieces if the scene does; call
+// before each step
+void driveScene(Scene& scene, double t);
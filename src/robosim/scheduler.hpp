@@ -0,0 +1,34 @@
+#pragma once
+
+// Hands out fixed-size physics steps to cover however much wall time a
+// render frame took. Leftover time stays in the accumulator and becomes the
+// interpolation factor for drawing.
+struct FixedStepScheduler {
+	double step;
+	double accumulator = 0;
+
+	// cap on catch-up work so one long hitch can't snowball into another
+	int maxStepsPerFrame = 32;
+
+	explicit FixedStepScheduler(double step) : step(step) {}
+
+	// returns how many steps to run for a frame that took frameTime seconds
+	int advance(double frameTime) {
+		accumulator += frameTime;
+		int steps = 0;
+		while (accumulator >= step && steps < maxStepsPerFrame) {
+			accumulator -= step;
+			steps++;
+		}
+		if (steps == maxStepsPerFrame && accumulator > step) {
+			// drop the time we can't catch up on instead of carrying it forever
+			accumulator = 0;
+		}
+		return steps;
+	}
+
+	// how far between the last two physics states the current frame sits
+	float alpha() const {
+		return static_cast<float>(accumulator / step);
+	}
+};
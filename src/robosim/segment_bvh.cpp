@@ -0,0 +1,240 @@
+#include "segment_bvh.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "field.hpp"
+#include "simd.hpp"
+
+namespace {
+
+struct Ray {
+	b2Vec2 origin;
+	b2Vec2 dir;
+	b2Vec2 invDir;
+};
+
+// slab test: does the ray enter box before best?
+inline bool hitsBox(b2AABB const& box, Ray const& ray, float best) {
+	float tx1 = (box.lowerBound.x - ray.origin.x) * ray.invDir.x;
+	float tx2 = (box.upperBound.x - ray.origin.x) * ray.invDir.x;
+	float ty1 = (box.lowerBound.y - ray.origin.y) * ray.invDir.y;
+	float ty2 = (box.upperBound.y - ray.origin.y) * ray.invDir.y;
+	float tmin = std::max(std::min(tx1, tx2), std::min(ty1, ty2));
+	float tmax = std::min(std::max(tx1, tx2), std::max(ty1, ty2));
+	return tmax >= std::max(tmin, 0.0f) && tmin < best;
+}
+
+// edges longer than this are split before building, so a perimeter wall
+// doesn't give every box it lands in the whole field's extent
+constexpr float kMaxSegmentLength = 1.0f;
+
+// o + t*d = a + s*e, by Cramer's rule; a hit needs t in [0, best) and s in
+// [0, 1]. Parallel and zero-length segments divide by zero and fail every
+// comparison, so they never hit.
+inline float packScalar(float const* ax, float const* ay, float const* ex, float const* ey, Ray const& ray, float best) {
+	for (int i = 0; i < SegmentBvh::kSegmentPack; i++) {
+		float px = ax[i] - ray.origin.x;
+		float py = ay[i] - ray.origin.y;
+		float inv = 1 / (ray.dir.x * ey[i] - ray.dir.y * ex[i]);
+		float t = (px * ey[i] - py * ex[i]) * inv;
+		float s = (px * ray.dir.y - py * ray.dir.x) * inv;
+		if (t >= 0 && t < best && s >= 0 && s <= 1) {
+			best = t;
+		}
+	}
+	return best;
+}
+
+#ifdef ROBOSIM_AVX2
+
+// packScalar for all eight lanes at once, then the smallest hit
+AVX2_FN inline float packAvx2(float const* ax, float const* ay, float const* ex, float const* ey, Ray const& ray, float best) {
+	__m256 px = _mm256_sub_ps(_mm256_loadu_ps(ax), _mm256_set1_ps(ray.origin.x));
+	__m256 py = _mm256_sub_ps(_mm256_loadu_ps(ay), _mm256_set1_ps(ray.origin.y));
+	__m256 vex = _mm256_loadu_ps(ex);
+	__m256 vey = _mm256_loadu_ps(ey);
+	__m256 dx = _mm256_set1_ps(ray.dir.x);
+	__m256 dy = _mm256_set1_ps(ray.dir.y);
+
+	__m256 inv = _mm256_div_ps(_mm256_set1_ps(1.0f), _mm256_sub_ps(_mm256_mul_ps(dx, vey), _mm256_mul_ps(dy, vex)));
+	__m256 t = _mm256_mul_ps(_mm256_sub_ps(_mm256_mul_ps(px, vey), _mm256_mul_ps(py, vex)), inv);
+	__m256 s = _mm256_mul_ps(_mm256_sub_ps(_mm256_mul_ps(px, dy), _mm256_mul_ps(py, dx)), inv);
+
+	__m256 vbest = _mm256_set1_ps(best);
+	__m256 zero = _mm256_setzero_ps();
+	__m256 hit = _mm256_and_ps(_mm256_cmp_ps(t, zero, _CMP_GE_OQ), _mm256_cmp_ps(t, vbest, _CMP_LT_OQ));
+	hit = _mm256_and_ps(hit, _mm256_cmp_ps(s, zero, _CMP_GE_OQ));
+	hit = _mm256_and_ps(hit, _mm256_cmp_ps(s, _mm256_set1_ps(1.0f), _CMP_LE_OQ));
+	if (_mm256_movemask_ps(hit) == 0) {
+		return best;
+	}
+
+	__m256 m = _mm256_blendv_ps(vbest, t, hit);
+	m = _mm256_min_ps(m, _mm256_permute2f128_ps(m, m, 1));
+	m = _mm256_min_ps(m, _mm256_shuffle_ps(m, m, _MM_SHUFFLE(1, 0, 3, 2)));
+	m = _mm256_min_ps(m, _mm256_shuffle_ps(m, m, _MM_SHUFFLE(2, 3, 0, 1)));
+	return _mm256_cvtss_f32(m);
+}
+
+#endif
+
+}
+
+void SegmentBvh::build(Field const& field) {
+	std::vector<Segment> segs;
+	auto add = [&segs](b2Vec2 a, b2Vec2 b) {
+		int pieces = std::max(1, static_cast<int>(std::ceil(b2Distance(a, b) / kMaxSegmentLength)));
+		for (int i = 0; i < pieces; i++) {
+			segs.push_back({a + (static_cast<float>(i) / pieces) * (b - a), a + (static_cast<float>(i + 1) / pieces) * (b - a)});
+		}
+	};
+
+	uint32_t count;
+	FieldChain const* chains = field.chains(count);
+	b2Vec2 const* verts = field.chainVertices();
+	for (uint32_t i = 0; i < count; i++) {
+		b2Vec2 const* v = verts + chains[i].first;
+		uint32_t n = chains[i].count;
+		for (uint32_t j = 0; j + 1 < n; j++) {
+			add(v[j], v[j + 1]);
+		}
+		if (chains[i].loop) {
+			add(v[n - 1], v[0]);
+		}
+	}
+
+	FieldPolygon const* polygons = field.polygons(count);
+	for (uint32_t i = 0; i < count; i++) {
+		FieldPolygon const& p = polygons[i];
+		for (int j = 0; j < p.count; j++) {
+			add(p.vertices[j], p.vertices[(j + 1) % p.count]);
+		}
+	}
+
+	nodes.clear();
+	packs.clear();
+	segments = static_cast<int>(segs.size());
+	if (!segs.empty()) {
+		buildNode(segs, 0, segs.size());
+	}
+	avx2 = haveAvx2();
+}
+
+uint32_t SegmentBvh::buildNode(std::vector<Segment>& segs, size_t begin, size_t end) {
+	uint32_t self = static_cast<uint32_t>(nodes.size());
+	nodes.push_back({});
+
+	b2AABB box{b2Vec2(b2_maxFloat, b2_maxFloat), b2Vec2(-b2_maxFloat, -b2_maxFloat)};
+	b2AABB centers = box;
+	for (size_t i = begin; i < end; i++) {
+		b2Vec2 lo = b2Min(segs[i].a, segs[i].b);
+		b2Vec2 hi = b2Max(segs[i].a, segs[i].b);
+		box.lowerBound = b2Min(box.lowerBound, lo);
+		box.upperBound = b2Max(box.upperBound, hi);
+		b2Vec2 c = 0.5f * (lo + hi);
+		centers.lowerBound = b2Min(centers.lowerBound, c);
+		centers.upperBound = b2Max(centers.upperBound, c);
+	}
+	nodes[self].box = box;
+
+	if (end - begin <= static_cast<size_t>(kSegmentPack)) {
+		Pack pack{};
+		for (size_t i = begin; i < end; i++) {
+			int lane = static_cast<int>(i - begin);
+			pack.ax[lane] = segs[i].a.x;
+			pack.ay[lane] = segs[i].a.y;
+			pack.ex[lane] = segs[i].b.x - segs[i].a.x;
+			pack.ey[lane] = segs[i].b.y - segs[i].a.y;
+		}
+		nodes[self].index = static_cast<uint32_t>(packs.size());
+		nodes[self].leaf = 1;
+		packs.push_back(pack);
+		return self;
+	}
+
+	// median split along the wider spread of segment centers
+	b2Vec2 spread = centers.upperBound - centers.lowerBound;
+	bool alongX = spread.x >= spread.y;
+	size_t mid = begin + (end - begin) / 2;
+	std::nth_element(segs.begin() + begin, segs.begin() + mid, segs.begin() + end, [alongX](Segment const& l, Segment const& r) {
+		return alongX ? l.a.x + l.b.x < r.a.x + r.b.x : l.a.y + l.b.y < r.a.y + r.b.y;
+	});
+	buildNode(segs, begin, mid);
+	uint32_t right = buildNode(segs, mid, end);
+	nodes[self].index = right;
+	nodes[self].leaf = 0;
+	return self;
+}
+
+float SegmentBvh::cast(b2Vec2 origin, b2Vec2 dir, float maxDist) const {
+	return traverse(origin, dir, maxDist, false);
+}
+
+float SegmentBvh::traverse(b2Vec2 origin, b2Vec2 dir, float maxDist, bool anyHit) const {
+	if (nodes.empty()) {
+		return maxDist;
+	}
+
+	// axis-parallel rays get a huge inverse rather than an infinite one, so
+	// a ray starting on a slab's edge is 0 * huge, not 0 * inf = NaN
+	Ray ray{origin, dir, {dir.x != 0 ? 1 / dir.x : b2_maxFloat, dir.y != 0 ? 1 / dir.y : b2_maxFloat}};
+	float best = maxDist;
+#ifdef ROBOSIM_AVX2
+	bool wide = simd && avx2;
+#endif
+
+	// the tree is shallow (a field has hundreds of edges, not millions)
+	uint32_t stack[64];
+	int top = 0;
+	stack[top++] = 0;
+	while (top > 0) {
+		Node const& node = nodes[stack[--top]];
+		if (!hitsBox(node.box, ray, best)) {
+			continue;
+		}
+		if (node.leaf) {
+			Pack const& p = packs[node.index];
+#ifdef ROBOSIM_AVX2
+			best = wide ? packAvx2(p.ax, p.ay, p.ex, p.ey, ray, best) : packScalar(p.ax, p.ay, p.ex, p.ey, ray, best);
+#else
+			best = packScalar(p.ax, p.ay, p.ex, p.ey, ray, best);
+#endif
+			if (anyHit && best < maxDist) {
+				return best;
+			}
+			continue;
+		}
+		uint32_t left = static_cast<uint32_t>(&node - nodes.data()) + 1;
+		// nearer child on top, so its hits shrink best before the far one
+		b2Vec2 mid = node.box.GetCenter();
+		bool leftFirst = (dir.x * (nodes[left].box.GetCenter().x - mid.x) + dir.y * (nodes[left].box.GetCenter().y - mid.y)) < 0;
+		stack[top++] = leftFirst ? node.index : left;
+		stack[top++] = leftFirst ? left : node.index;
+	}
+	return best;
+}
+
+void SegmentBvh::castFan(b2Vec2 origin, b2Vec2 const* dirs, int n, float maxDist, float* dist) const {
+	for (int i = 0; i < n; i++) {
+		dist[i] = cast(origin, dirs[i], maxDist);
+	}
+}
+
+bool SegmentBvh::blocked(b2Vec2 a, b2Vec2 b) const {
+	b2Vec2 d = b - a;
+	float len = d.Length();
+	if (len < b2_epsilon) {
+		return false;
+	}
+	d *= 1 / len;
+	// a little short of b, for targets mounted on a wall
+	float reach = std::max(0.0f, len - 0.01f);
+	return traverse(a, d, reach, true) < reach;
+}
+
+void SegmentBvh::blocked(b2Vec2 const* from, b2Vec2 const* to, int n, bool* out) const {
+	for (int i = 0; i < n; i++) {
+		out[i] = blocked(from[i], to[i]);
+	}
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <box2d/box2d.h>
+
+class Field;
+
+// Every static edge of a field (walls and element outlines) in a flat
+// bounding volume hierarchy built for casting lots of rays at once. Nodes
+// are stored depth first, so a node's left child is the next node. Each
+// leaf owns one pack of up to kSegmentPack segments, stored as
+// structure-of-arrays so the AVX2 path tests a ray against the whole pack
+// in one go. Unused lanes hold zero-length segments, which never hit.
+//
+// The field never moves, so it's built once and only read after that; any
+// number of threads can cast against it.
+class SegmentBvh {
+public:
+	static constexpr int kSegmentPack = 8;
+
+	void build(Field const& field);
+
+	// distance along dir (unit length) from origin to the nearest edge,
+	// or maxDist if nothing is closer
+	float cast(b2Vec2 origin, b2Vec2 dir, float maxDist) const;
+
+	// cast() for n rays from one origin, into dist[i]
+	void castFan(b2Vec2 origin, b2Vec2 const* dirs, int n, float maxDist, float* dist) const;
+
+	// whether any edge crosses the segment from a to b (exclusive of b,
+	// so a target sitting on a wall isn't hidden by that wall)
+	bool blocked(b2Vec2 a, b2Vec2 b) const;
+
+	// blocked() for n sight lines, into out[i]. Stops at the first edge
+	// found on each one rather than looking for the nearest.
+	void blocked(b2Vec2 const* from, b2Vec2 const* to, int n, bool* out) const;
+
+	int segmentCount() const { return segments; }
+	int nodeCount() const { return static_cast<int>(nodes.size()); }
+
+	// false to force the scalar pack test, for comparing the two
+	bool simd = true;
+
+private:
+	struct Node {
+		b2AABB box;
+		// leaf: its pack; internal: the right child
+		uint32_t index;
+		uint32_t leaf;
+	};
+
+	struct Pack {
+		// segment start and its offset to the end
+		float ax[kSegmentPack];
+		float ay[kSegmentPack];
+		float ex[kSegmentPack];
+		float ey[kSegmentPack];
+	};
+
+	struct Segment {
+		b2Vec2 a;
+		b2Vec2 b;
+	};
+
+	uint32_t buildNode(std::vector<Segment>& segs, size_t begin, size_t end);
+
+	// the nearest hit closer than maxDist, or with anyHit the first one
+	// found, or maxDist if there's none
+	float traverse(b2Vec2 origin, b2Vec2 dir, float maxDist, bool anyHit) const;
+
+	std::vector<Node> nodes;
+	std::vector<Pack> packs;
+	int segments = 0;
+	bool avx2 = false;
+};
@@ -0,0 +1,245 @@
+#include "sim.hpp"
+
+#include <cmath>
+
+#include "drivetrain.hpp"
+#include "hal_bridge.hpp"
+#include "physics_panel.hpp"
+#include "profiler.hpp"
+#include "robot.hpp"
+#include "robot_program.hpp"
+#include "scenes.hpp"
+#include "simlog.hpp"
+#include "telemetry.hpp"
+
+float SensorNoise::sample(uint32_t sensor) {
+	uint32_t block = sensor / 4;
+	if (tick != cachedTick || block != cachedBlock) {
+		PhiloxCounter ctr{static_cast<uint32_t>(tick), static_cast<uint32_t>(tick >> 32), botId, block};
+		cached = gaussian4(ctr, key);
+		cachedTick = tick;
+		cachedBlock = block;
+	}
+	return stddev * cached[sensor % 4];
+}
+
+void SensorNoise::fillNormals(uint32_t first, float* out, size_t n) const {
+	fillGaussian(out, n, {static_cast<uint32_t>(tick), static_cast<uint32_t>(tick >> 32), botId, first / 4}, key);
+}
+
+float Bot::getAngle() {
+	return angle + noise->sample(kSensorAngle);
+}
+
+float Bot::getVel() {
+	return vel + noise->sample(kSensorVel);
+}
+
+Vector2 Bot::getPos() {
+	return {pos.x + noise->sample(kSensorPosX), pos.y + noise->sample(kSensorPosY)};
+}
+
+float botDamping(float timeStep) {
+	return std::pow(0.975f, timeStep * kTuningRate);
+}
+
+DriverInput readKeyboard() {
+	return {IsKeyDown(KEY_LEFT), IsKeyDown(KEY_RIGHT), IsKeyDown(KEY_UP), IsKeyDown(KEY_DOWN)};
+}
+
+Sim::Sim(int physicsHz, uint32_t seed, uint32_t botId)
+	: noise(seed, botId)
+	, physicsHz(physicsHz)
+	, timeStep(1.0f / physicsHz)
+	, ticksPerPeriodic(physicsHz / kRobotHz)
+	, damping(botDamping(timeStep))
+{
+	b2BodyDef groundBodyDef;
+	groundBodyDef.position.Set(0.0f, -10.0f);
+	b2Body* groundBody = world.CreateBody(&groundBodyDef);
+	b2PolygonShape groundBox;
+	groundBox.SetAsBox(50.0f, 10.0f);
+	groundBody->CreateFixture(&groundBox, 0.0f);
+
+	b2BodyDef bodyDef;
+	bodyDef.type = b2_dynamicBody;
+	bodyDef.position.Set(0.0f, 4.0f);
+	b2Body* body = world.CreateBody(&bodyDef);
+	b2PolygonShape dynamicBox;
+	dynamicBox.SetAsBox(1.0f, 1.0f);
+	b2FixtureDef fixtureDef;
+	fixtureDef.shape = &dynamicBox;
+	fixtureDef.density = 1.0f;
+	fixtureDef.friction = 0.3f;
+	body->CreateFixture(&fixtureDef);
+}
+
+void Sim::attachDrivetrain(TankDrivetrain& d) {
+	while (b2Body* b = world.GetBodyList()) {
+		world.DestroyBody(b);
+	}
+	world.SetGravity({0, 0});
+	addFieldWalls(world, kFieldWidth / kPixelsPerMeter, kFieldHeight / kPixelsPerMeter);
+
+	drivetrain = &d;
+	drivetrain->create(world, {bot.pos.x / kPixelsPerMeter, bot.pos.y / kPixelsPerMeter}, DEG2RAD * bot.angle);
+	substeps = (kDrivetrainHz + physicsHz - 1) / physicsHz;
+}
+
+static void addProfile(b2Profile& sum, b2Profile const& p) {
+	sum.step += p.step;
+	sum.collide += p.collide;
+	sum.solve += p.solve;
+	sum.solveInit += p.solveInit;
+	sum.solveVelocity += p.solveVelocity;
+	sum.solvePosition += p.solvePosition;
+	sum.broadphase += p.broadphase;
+	sum.solveTOI += p.solveTOI;
+}
+
+void Sim::stepDrivetrain() {
+	tickProfile = {};
+	float dt = timeStep / substeps;
+	for (int i = 0; i < substeps; i++) {
+		drivetrain->update(dt);
+		PROFILE_ZONE("b2World::Step");
+		world.Step(dt, velocityIterations, positionIterations);
+		addProfile(tickProfile, world.GetProfile());
+	}
+
+	b2Body const* body = drivetrain->body;
+	bot.pos = {body->GetPosition().x * kPixelsPerMeter, body->GetPosition().y * kPixelsPerMeter};
+	bot.angle = RAD2DEG * body->GetAngle();
+	bot.vel = drivetrain->speed() * kPixelsPerMeter / kTuningRate;
+}
+
+void Sim::step() {
+	PROFILE_ZONE("Sim::step");
+
+	if (tick % ticksPerPeriodic == 0) {
+		PROFILE_ZONE("periodic");
+		noise.tick = tick;
+
+		// same tick, so these are exactly the readings periodic() will get
+		lastIo.sensedAngle = bot.getAngle();
+		lastIo.sensedVel = bot.getVel();
+		lastIo.sensedPos = bot.getPos();
+
+		float vel0 = bot.vel;
+		float angle0 = bot.angle;
+		if (program || hal) {
+			RobotLoopIo io{};
+			io.time = time();
+			io.sensedAngle = lastIo.sensedAngle;
+			io.sensedVel = lastIo.sensedVel;
+			io.sensedPosX = lastIo.sensedPos.x;
+			io.sensedPosY = lastIo.sensedPos.y;
+			io.angle = bot.angle;
+			io.vel = bot.vel;
+			io.left = input.left;
+			io.right = input.right;
+			io.up = input.up;
+			io.down = input.down;
+			if (hal) {
+				// with no robot attached the bot keeps its last commands
+				hal->exchange(io, tick, std::llround(odometer * kHalCountsPerPixel));
+			} else {
+				program->periodic(io);
+			}
+			bot.angle = io.angle;
+			bot.vel = io.vel;
+		} else {
+			periodic(bot, input);
+		}
+		lastIo.cmdVel = bot.vel - vel0;
+		lastIo.cmdAngle = bot.angle - angle0;
+
+		if (drivetrain) {
+			// the robot loop's commands, held until its next run; bot goes
+			// back to what the chassis measures after every substep
+			DrivetrainState& state = drivetrain->state;
+			state.targetSpeed = bot.vel * kTuningRate / kPixelsPerMeter;
+			state.targetHeading = DEG2RAD * bot.angle;
+		}
+	}
+
+	if (drivetrain) {
+		stepDrivetrain();
+	} else {
+		PROFILE_ZONE("b2World::Step");
+		world.Step(timeStep, velocityIterations, positionIterations);
+		tickProfile = world.GetProfile();
+	}
+	if (physicsPanel) {
+		physicsPanel->publish(world, tickProfile, (tick + 1) / static_cast<double>(physicsHz));
+	}
+
+	if (!drivetrain) {
+		integrateBot(bot.angle, bot.vel, bot.pos.x, bot.pos.y, damping, timeStep * kTuningRate);
+	}
+	odometer += timeStep * kTuningRate * bot.vel;
+
+	tick++;
+
+	float e = err();
+	if (e > maxErr) {
+		maxErr = e;
+	}
+
+	if (publishing) {
+		double t = time();
+		channels.vel->publish(t, bot.vel);
+		channels.angle->publish(t, bot.angle);
+		channels.posX->publish(t, bot.pos.x);
+		channels.posY->publish(t, bot.pos.y);
+		channels.err->publish(t, e);
+		if (drivetrain) {
+			channels.busVoltage->publish(t, drivetrain->state.busVoltage);
+			channels.batteryCurrent->publish(t, drivetrain->state.batteryCurrent);
+		}
+	}
+
+	if (log) {
+		log->append(record());
+	}
+}
+
+double Sim::time() const {
+	return tick / static_cast<double>(physicsHz);
+}
+
+float Sim::err() const {
+	return pow(bot.pos.y - kFieldHeight / 2, 2);
+}
+
+LogRecord Sim::record() const {
+	LogRecord r;
+	r.tick = tick;
+	r.angle = bot.angle;
+	r.vel = bot.vel;
+	r.posX = bot.pos.x;
+	r.posY = bot.pos.y;
+	r.sensedAngle = lastIo.sensedAngle;
+	r.sensedVel = lastIo.sensedVel;
+	r.sensedPosX = lastIo.sensedPos.x;
+	r.sensedPosY = lastIo.sensedPos.y;
+	r.cmdVel = lastIo.cmdVel;
+	r.cmdAngle = lastIo.cmdAngle;
+	r.err = err();
+	r.input = input.left | input.right << 1 | input.up << 2 | input.down << 3;
+	return r;
+}
+
+void Sim::attachTelemetry(Telemetry& telemetry) {
+	float hz = static_cast<float>(physicsHz);
+	channels.vel = telemetry.add("Velocity", hz);
+	channels.angle = telemetry.add("Angle", hz);
+	channels.posX = telemetry.add("Position X", hz);
+	channels.posY = telemetry.add("Position Y", hz);
+	channels.err = telemetry.add("Err", hz);
+	if (drivetrain) {
+		channels.busVoltage = telemetry.add("Battery Voltage", hz);
+		channels.batteryCurrent = telemetry.add("Battery Current", hz);
+	}
+	publishing = true;
+}
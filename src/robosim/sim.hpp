@@ -0,0 +1,198 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+#include <raylib.h>
+#include <box2d/box2d.h>
+
+#include "rng.hpp"
+
+class LogWriter;
+class HalBridge;
+class PhysicsPanel;
+class RobotProgram;
+class TankDrivetrain;
+class Telemetry;
+struct LogRecord;
+struct TelemetryChannel;
+
+// the bot still lives in screen pixels, centered on the original window
+constexpr float kFieldWidth = 1280.0f;
+constexpr float kFieldHeight = 720.0f;
+
+// the bot's constants were originally tuned per frame at this rate
+constexpr float kTuningRate = 60.0f;
+
+// world scale once the bot is a physical chassis, so the pixel field is
+// 32 x 18 m
+constexpr float kPixelsPerMeter = 40.0f;
+
+// the chassis' motors and tires are stepped at least this often
+constexpr int kDrivetrainHz = 1000;
+
+// which reading a noise sample belongs to; each group of four shares a
+// philox block
+enum SensorId : uint32_t {
+	kSensorAngle,
+	kSensorVel,
+	kSensorPosX,
+	kSensorPosY,
+
+	// a lidar's beams, one sensor each from here up
+	kSensorLidar = 4,
+
+	// camera tag sightings, one block each from here up; well clear of
+	// any lidar's beams
+	kSensorCamera = 1u << 20,
+};
+
+// Gaussian sensor noise keyed by (seed, bot, sensor, tick), so a run can be
+// replayed exactly from its seed and parallel runs share nothing. Reading
+// the same sensor twice in one tick gives the same value.
+struct SensorNoise {
+	PhiloxKey key;
+	uint32_t botId;
+	float stddev = 3.0f;
+
+	// set by whoever steps the bot, before its sensors are read
+	uint64_t tick = 0;
+
+	SensorNoise(uint32_t seed, uint32_t botId) : key{seed, 0}, botId(botId) {}
+
+	float sample(uint32_t sensor);
+
+	// unit normals for sensors first..first+n, the same ones sample() scales
+	// by stddev; first must start a block (a multiple of 4)
+	void fillNormals(uint32_t first, float* out, size_t n) const;
+
+private:
+	uint64_t cachedTick = ~0ull;
+	uint32_t cachedBlock = 0;
+	std::array<float, 4> cached;
+};
+
+struct Bot {
+	float angle;
+	float vel;
+	Vector2 pos;
+	SensorNoise* noise;
+
+	float getAngle();
+	float getVel();
+	Vector2 getPos();
+};
+
+// one kinematics step for a single bot. BotBatch's scalar path calls this
+// too, which is what keeps the two bit-for-bit identical. The heading is
+// never wrapped where it's kept, so it's wrapped to [-180, 180] here first;
+// sin and cos of a long run's huge angle lose precision otherwise.
+inline void integrateBot(float angle, float& vel, float& x, float& y, float damping, float k) {
+	float heading = DEG2RAD * remainderf(angle, 360.0f);
+	vel *= damping;
+	x += k * vel * cosf(heading);
+	y += k * vel * sinf(heading);
+}
+
+// per-step velocity decay equivalent to the original 0.975 per 60 fps frame
+float botDamping(float timeStep);
+
+// what the keyboard is doing; always empty when headless
+struct DriverInput {
+	bool left = false;
+	bool right = false;
+	bool up = false;
+	bool down = false;
+};
+
+DriverInput readKeyboard();
+
+struct Sim {
+	b2World world{b2Vec2(0, -10)};
+	SensorNoise noise;
+	Bot bot{0, 0, {kFieldWidth / 2.0f, kFieldHeight / 2.0f}, &noise};
+	DriverInput input;
+
+	int physicsHz;
+	float timeStep;
+	int32 velocityIterations = 6;
+	int32 positionIterations = 2;
+
+	int64_t tick = 0;
+	float maxErr = 0;
+
+	// signed distance the bot has driven, in pixels, for its encoder
+	double odometer = 0;
+
+	// what the robot program last read and what it changed, for the log
+	struct RobotIo {
+		float sensedAngle;
+		float sensedVel;
+		Vector2 sensedPos;
+		float cmdVel;
+		float cmdAngle;
+	};
+	RobotIo lastIo{};
+
+	// every tick gets appended here when set
+	LogWriter* log = nullptr;
+
+	// gets Box2D's profile after every world step when set
+	PhysicsPanel* physicsPanel = nullptr;
+
+	// runs instead of the built-in periodic() when set
+	RobotProgram* program = nullptr;
+
+	// when set, an external robot process drives the bot in lockstep
+	// instead, whenever one is attached
+	HalBridge* hal = nullptr;
+
+	// when set, the bot is this chassis in a top-down world instead of a
+	// point with made-up kinematics; see attachDrivetrain()
+	TankDrivetrain* drivetrain = nullptr;
+
+	// physicsHz must be a multiple of kRobotHz so periodic() lands on a tick
+	Sim(int physicsHz, uint32_t seed, uint32_t botId = 0);
+
+	// swaps the demo world for a gravity-free one, walled in at the window's
+	// edges (kPixelsPerMeter), with the drivetrain's chassis where the bot
+	// is. From then on the robot loop's vel and angle are speed and heading
+	// targets, and the bot reports what the chassis actually does. Call
+	// before anything else looks at the world.
+	void attachDrivetrain(TankDrivetrain& drivetrain);
+
+	// advances one physics tick, running the robot loop when it's due
+	void step();
+
+	double time() const;
+	float err() const;
+
+	LogRecord record() const;
+
+	// registers the bot's channels and publishes to them every tick
+	void attachTelemetry(Telemetry& telemetry);
+
+private:
+	struct Channels {
+		TelemetryChannel* vel;
+		TelemetryChannel* angle;
+		TelemetryChannel* posX;
+		TelemetryChannel* posY;
+		TelemetryChannel* err;
+		TelemetryChannel* busVoltage;
+		TelemetryChannel* batteryCurrent;
+	};
+	Channels channels{};
+	bool publishing = false;
+
+	int ticksPerPeriodic;
+	float damping;
+
+	// drivetrain substeps per tick, to reach kDrivetrainHz
+	int substeps = 1;
+
+	// Box2D's profile summed over this tick's substeps, for the panel
+	b2Profile tickProfile{};
+
+	void stepDrivetrain();
+};
@@ -0,0 +1,129 @@
+#include "sim_thread.hpp"
+
+#include <chrono>
+
+#include "hal_bridge.hpp"
+#include "profiler.hpp"
+#include "robot_program.hpp"
+#include "scheduler.hpp"
+
+SimThread::SimThread(Sim& sim) : sim(sim) {
+	// so the render thread has something to draw before the first step
+	captureRenderState(sim, prev);
+	publish();
+	frames.acquire();
+}
+
+SimThread::~SimThread() {
+	stop();
+}
+
+void SimThread::start() {
+	if (running.exchange(true)) {
+		return;
+	}
+	thread = std::thread(&SimThread::run, this);
+}
+
+void SimThread::stop() {
+	running.store(false);
+	if (thread.joinable()) {
+		thread.join();
+	}
+}
+
+void SimThread::setInput(DriverInput const& input) {
+	uint8_t bits = input.left | input.right << 1 | input.up << 2 | input.down << 3;
+	inputBits.store(bits, std::memory_order_relaxed);
+}
+
+void SimThread::setView(b2AABB const* view) {
+	ViewRequest& request = views.back();
+	request.cull = view != nullptr;
+	if (view) {
+		// a body a little off screen may still be drawn partly on it by the
+		// time this frame is shown
+		b2Vec2 margin = 0.1f * (view->upperBound - view->lowerBound) + b2Vec2(1, 1);
+		request.view.lowerBound = view->lowerBound - margin;
+		request.view.upperBound = view->upperBound + margin;
+	}
+	views.publish();
+}
+
+void SimThread::publish() {
+	ViewRequest const& request = views.acquire();
+	RenderFrame& frame = frames.back();
+	captureRenderFrame(sim, prev, request.cull ? &request.view : nullptr, capture, frame);
+	frame.haveSnapshot = !snapshot.empty();
+	frame.snapshotBytes = snapshot.bytes();
+	frame.captureUs = captureUs;
+	frame.restoreUs = restoreUs;
+	frame.restoreFailed = restoreFailed;
+	frame.programReloads = sim.program ? sim.program->reloads() : -1;
+	frame.hal = sim.hal != nullptr;
+	if (sim.hal) {
+		frame.halAttached = sim.hal->attached();
+		frame.halMeanUs = sim.hal->meanRoundTripUs;
+		frame.halMaxUs = sim.hal->maxRoundTripUs;
+	}
+	frame.publishedNs = profilerNowNs();
+	frames.publish();
+}
+
+void SimThread::run() {
+	using clock = std::chrono::steady_clock;
+
+	profilerSetThreadName("sim");
+
+	FixedStepScheduler scheduler{sim.timeStep};
+	auto last = clock::now();
+	while (running.load(std::memory_order_relaxed)) {
+		auto now = clock::now();
+		int steps = scheduler.advance(std::chrono::duration<double>(now - last).count());
+		last = now;
+
+		// a rebuilt robot program takes over between ticks
+		if (sim.program) {
+			sim.program->poll();
+		}
+
+		uint8_t bits = inputBits.load(std::memory_order_relaxed);
+		sim.input = {(bits & 1) != 0, (bits & 2) != 0, (bits & 4) != 0, (bits & 8) != 0};
+
+		bool changed = false;
+		{
+			PROFILE_ZONE("physics");
+			for (int i = 0; i < steps; i++) {
+				if (i == steps - 1) {
+					captureRenderState(sim, prev);
+				}
+				sim.step();
+			}
+			changed = steps > 0;
+		}
+
+		// between steps, so what's drawn and what's captured always agree
+		if (captureRequested.exchange(false, std::memory_order_relaxed)) {
+			auto start = clock::now();
+			snapshot.capture(sim);
+			captureUs = std::chrono::duration<float, std::micro>(clock::now() - start).count();
+			changed = true;
+		}
+		if (restoreRequested.exchange(false, std::memory_order_relaxed) && !snapshot.empty()) {
+			auto start = clock::now();
+			restoreFailed = !snapshot.restore(sim);
+			restoreUs = std::chrono::duration<float, std::micro>(clock::now() - start).count();
+			captureRenderState(sim, prev);
+			changed = true;
+		}
+
+		if (changed) {
+			PROFILE_ZONE("publish frame");
+			publish();
+		}
+
+		// sleep until the next step is due rather than spinning a core
+		double untilNext = scheduler.step - scheduler.accumulator;
+		std::this_thread::sleep_until(now + std::chrono::duration<double>(untilNext));
+	}
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+#include "render.hpp"
+#include "sim.hpp"
+#include "snapshot.hpp"
+#include "triple_buffer.hpp"
+
+// Runs a Sim in realtime on its own thread, so a slow frame can't hold up
+// physics and a slow step can't hold up drawing. After every step it
+// publishes a RenderFrame through a triple buffer; the render thread picks
+// up the newest one without locking and never touches the Sim itself.
+//
+// Everything else crosses threads the way it already could: telemetry,
+// the physics panel and profiler zones through their SPSC rings, driver
+// input and snapshot requests through atomics below.
+class SimThread {
+public:
+	// sim must outlive the thread; don't touch it between start() and stop()
+	explicit SimThread(Sim& sim);
+	~SimThread();
+
+	void start();
+	void stop();
+
+	// render thread side
+	void setInput(DriverInput const& input);
+	void requestCapture() { captureRequested.store(true, std::memory_order_relaxed); }
+	void requestRestore() { restoreRequested.store(true, std::memory_order_relaxed); }
+
+	// what's on screen, in meters, or null to capture everything. It's
+	// padded before the broadphase query, since the frames it culls are
+	// drawn a little later and interpolated.
+	void setView(b2AABB const* view);
+
+	// the newest published frame; stays valid until the next call
+	RenderFrame const& latest() { return frames.acquire(); }
+
+private:
+	void run();
+	void publish();
+
+	Sim& sim;
+	std::thread thread;
+	std::atomic<bool> running{false};
+
+	std::atomic<uint8_t> inputBits{0};
+	std::atomic<bool> captureRequested{false};
+	std::atomic<bool> restoreRequested{false};
+
+	struct ViewRequest {
+		bool cull = false;
+		b2AABB view{};
+	};
+	TripleBuffer<ViewRequest> views;
+
+	// sim thread only
+	RenderState prev;
+	RenderCapture capture;
+	WorldSnapshot snapshot;
+	float captureUs = 0;
+	float restoreUs = 0;
+	bool restoreFailed = false;
+
+	TripleBuffer<RenderFrame> frames;
+};
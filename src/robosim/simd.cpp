@@ -0,0 +1,32 @@
+#include "simd.hpp"
+
+#if defined(ROBOSIM_AVX2) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#ifdef ROBOSIM_AVX2
+
+bool haveAvx2() {
+#ifdef _MSC_VER
+	int info[4];
+	__cpuid(info, 0);
+	if (info[0] < 7) {
+		return false;
+	}
+	__cpuidex(info, 7, 0);
+	bool avx2 = (info[1] & (1 << 5)) != 0;
+	__cpuid(info, 1);
+	bool fma = (info[2] & (1 << 12)) != 0;
+	return avx2 && fma;
+#else
+	return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+}
+
+#else
+
+bool haveAvx2() {
+	return false;
+}
+
+#endif
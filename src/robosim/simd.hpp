@@ -0,0 +1,20 @@
+#pragma once
+
+// Which SIMD kernels this build has. They're x86-64 AVX2 only for now, and
+// ROBOSIM_NO_SIMD leaves them out entirely. Every kernel has a scalar path
+// and is picked at runtime with haveAvx2().
+#if !defined(ROBOSIM_NO_SIMD) && (defined(__x86_64__) || defined(_M_X64))
+#define ROBOSIM_AVX2 1
+#include <immintrin.h>
+#endif
+
+// MSVC lets us use AVX2 intrinsics anywhere; gcc and clang need the
+// function marked so the rest of the build can stay baseline x86-64
+#if defined(ROBOSIM_AVX2) && !defined(_MSC_VER)
+#define AVX2_FN __attribute__((target("avx2,fma")))
+#else
+#define AVX2_FN
+#endif
+
+// true if this build has the AVX2 kernels and the CPU can run them
+bool haveAvx2();
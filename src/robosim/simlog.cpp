@@ -0,0 +1,209 @@
+#include "simlog.hpp"
+
+#include <cstring>
+
+namespace {
+
+char const kFileMagic[8] = {'R', 'S', 'I', 'M', 'L', 'O', 'G', '1'};
+char const kIndexMagic[8] = {'R', 'S', 'I', 'M', 'I', 'D', 'X', '1'};
+uint32_t const kBlockMagic = 0x314b4c42; // "BLK1"
+
+struct FileHeader {
+	char magic[8];
+	uint32_t recordSize;
+	uint32_t blockTicks;
+	uint32_t physicsHz;
+	uint32_t seed;
+	uint64_t reserved;
+};
+
+struct BlockHeader {
+	uint32_t magic;
+	uint32_t count;
+	int64_t firstTick;
+};
+
+struct Footer {
+	uint64_t indexOffset;
+	uint64_t blockCount;
+	char magic[8];
+};
+
+// whether a whole block with a good header starts at `at`
+bool blockFits(unsigned char const* data, uint64_t size, uint64_t at, BlockHeader& bh) {
+	if (at > size || size - at < sizeof(BlockHeader)) {
+		return false;
+	}
+	memcpy(&bh, data + at, sizeof(bh));
+	return bh.magic == kBlockMagic && bh.count > 0 && bh.count <= kLogBlockTicks
+		&& (size - at - sizeof(bh)) / sizeof(LogRecord) >= bh.count;
+}
+
+}
+
+LogWriter::~LogWriter() {
+	close();
+}
+
+bool LogWriter::open(char const* path, uint32_t physicsHz, uint32_t seed) {
+	close();
+
+	file = fopen(path, "wb");
+	if (!file) {
+		perror(path);
+		return false;
+	}
+
+	FileHeader header{};
+	memcpy(header.magic, kFileMagic, sizeof(header.magic));
+	header.recordSize = sizeof(LogRecord);
+	header.blockTicks = kLogBlockTicks;
+	header.physicsHz = physicsHz;
+	header.seed = seed;
+	this->path = path;
+	failed = false;
+	write(&header, sizeof(header), 1);
+	offset = sizeof(header);
+
+	block.clear();
+	block.reserve(kLogBlockTicks);
+	index.clear();
+	return true;
+}
+
+void LogWriter::write(void const* data, size_t size, size_t count) {
+	if (failed || fwrite(data, size, count, file) == count) {
+		return;
+	}
+	// a full disk; say so once rather than leaving a short log that looks fine
+	perror(path.c_str());
+	fprintf(stderr, "%s: write failed, the log stops after %llu records\n", path.c_str(),
+		static_cast<unsigned long long>(index.size() * kLogBlockTicks));
+	failed = true;
+}
+
+void LogWriter::append(LogRecord const& record) {
+	block.push_back(record);
+	if (block.size() == kLogBlockTicks) {
+		flushBlock();
+	}
+}
+
+void LogWriter::flushBlock() {
+	if (block.empty()) {
+		return;
+	}
+
+	BlockHeader header{kBlockMagic, static_cast<uint32_t>(block.size()), block.front().tick};
+	write(&header, sizeof(header), 1);
+	write(block.data(), sizeof(LogRecord), block.size());
+	if (failed) {
+		block.clear();
+		return;
+	}
+
+	index.push_back(offset);
+	offset += sizeof(header) + sizeof(LogRecord) * block.size();
+	block.clear();
+}
+
+void LogWriter::close() {
+	if (!file) {
+		return;
+	}
+
+	flushBlock();
+
+	Footer footer{offset, index.size(), {}};
+	memcpy(footer.magic, kIndexMagic, sizeof(footer.magic));
+	write(index.data(), sizeof(uint64_t), index.size());
+	write(&footer, sizeof(footer), 1);
+
+	if (fclose(file) != 0 && !failed) {
+		perror(path.c_str());
+	}
+	file = nullptr;
+}
+
+bool LogReader::open(char const* path) {
+	if (!file.open(path)) {
+		return false;
+	}
+
+	unsigned char const* data = file.data();
+	size_t size = file.size();
+
+	FileHeader header;
+	if (size < sizeof(header)) {
+		fprintf(stderr, "%s: too short to be a log\n", path);
+		return false;
+	}
+	memcpy(&header, data, sizeof(header));
+	if (memcmp(header.magic, kFileMagic, sizeof(kFileMagic)) != 0 || header.recordSize != sizeof(LogRecord) || header.blockTicks != kLogBlockTicks) {
+		fprintf(stderr, "%s: not a robosim log, or from an incompatible version\n", path);
+		return false;
+	}
+	hz = header.physicsHz;
+	runSeed = header.seed;
+
+	// every block but the last must be full for at() to find records by
+	// division, and every one must lie inside the file
+	auto blocksFit = [&](uint64_t const* offsets, uint64_t n) {
+		for (uint64_t i = 0; i < n; i++) {
+			BlockHeader bh;
+			if (!blockFits(data, size, offsets[i], bh) || (i + 1 < n && bh.count != kLogBlockTicks)) {
+				return false;
+			}
+		}
+		return true;
+	};
+
+	Footer footer;
+	bool haveFooter = false;
+	if (size >= sizeof(header) + sizeof(footer)) {
+		memcpy(&footer, data + size - sizeof(footer), sizeof(footer));
+		// no multiplying, so a corrupt count can't overflow its way past this
+		uint64_t indexSpace = size - sizeof(footer);
+		haveFooter = memcmp(footer.magic, kIndexMagic, sizeof(kIndexMagic)) == 0
+			&& footer.indexOffset >= sizeof(header) && footer.indexOffset <= indexSpace
+			&& footer.indexOffset % alignof(uint64_t) == 0
+			&& (indexSpace - footer.indexOffset) / sizeof(uint64_t) == footer.blockCount
+			&& (indexSpace - footer.indexOffset) % sizeof(uint64_t) == 0
+			&& blocksFit(reinterpret_cast<uint64_t const*>(data + footer.indexOffset), footer.blockCount);
+	}
+
+	if (haveFooter) {
+		index = reinterpret_cast<uint64_t const*>(data + footer.indexOffset);
+		blocks = footer.blockCount;
+	} else {
+		// the writer never got to close(), or the index is bad; walk the
+		// blocks that made it out, up to the first short one
+		scannedIndex.clear();
+		uint64_t at = sizeof(header);
+		BlockHeader bh;
+		while (blockFits(data, size, at, bh)) {
+			scannedIndex.push_back(at);
+			if (bh.count != kLogBlockTicks) {
+				break;
+			}
+			at += sizeof(bh) + uint64_t(bh.count) * sizeof(LogRecord);
+		}
+		index = scannedIndex.data();
+		blocks = scannedIndex.size();
+		fprintf(stderr, "%s: no usable index (run didn't finish?), recovered %llu blocks\n", path, static_cast<unsigned long long>(blocks));
+	}
+
+	count = 0;
+	if (blocks > 0) {
+		BlockHeader last;
+		memcpy(&last, data + index[blocks - 1], sizeof(last));
+		count = static_cast<int64_t>(blocks - 1) * kLogBlockTicks + last.count;
+	}
+	return true;
+}
+
+LogRecord const& LogReader::at(int64_t i) const {
+	uint64_t blockStart = index[i / kLogBlockTicks];
+	size_t offset = blockStart + sizeof(BlockHeader) + (i % kLogBlockTicks) * sizeof(LogRecord);
+	return *reinterpret_cast<LogRecord const*>(file.data() + offset);
+}
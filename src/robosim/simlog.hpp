@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "mapped_file.hpp"
+
+// One physics tick of a run. Written and mapped back as raw bytes, so the
+// layout is the file format (little-endian, 56 bytes).
+struct LogRecord {
+	int64_t tick;
+
+	// true bot state after the tick
+	float angle;
+	float vel;
+	float posX;
+	float posY;
+
+	// what the robot program read at its most recent periodic()
+	float sensedAngle;
+	float sensedVel;
+	float sensedPosX;
+	float sensedPosY;
+
+	// how much that periodic() changed velocity and heading
+	float cmdVel;
+	float cmdAngle;
+
+	float err;
+
+	// DriverInput as bits: left, right, up, down
+	uint32_t input;
+};
+static_assert(sizeof(LogRecord) == 56, "LogRecord is the on-disk format");
+
+// File layout: a header, then blocks of up to kLogBlockTicks records each
+// behind a small block header, then an index of block offsets and a footer
+// pointing at it. Every block but the last is full, so finding a tick is
+// one division and one index lookup.
+constexpr uint32_t kLogBlockTicks = 1024;
+
+// Append-only writer. Records collect in a one-block buffer and go out a
+// block at a time; close() writes the index. A failed write (a full disk)
+// is reported once, and the log ends at the last whole block before it.
+class LogWriter {
+public:
+	LogWriter() = default;
+	LogWriter(LogWriter const&) = delete;
+	LogWriter& operator=(LogWriter const&) = delete;
+	~LogWriter();
+
+	// prints the reason and returns false on failure
+	bool open(char const* path, uint32_t physicsHz, uint32_t seed);
+	void append(LogRecord const& record);
+	void close();
+
+	bool isOpen() const { return file != nullptr; }
+
+private:
+	void flushBlock();
+	void write(void const* data, size_t size, size_t count);
+
+	FILE* file = nullptr;
+	std::string path;
+	bool failed = false;
+	std::vector<LogRecord> block;
+	std::vector<uint64_t> index;
+	uint64_t offset = 0;
+};
+
+// Maps a log and hands out records by index without copying. Logs from a
+// run that never called close() are still readable: the block headers are
+// scanned to rebuild the index. Every indexed block is checked to lie
+// inside the file, so a truncated or corrupt log can't make at() read
+// past the mapping.
+class LogReader {
+public:
+	bool open(char const* path);
+
+	int64_t size() const { return count; }
+	uint32_t physicsHz() const { return hz; }
+	uint32_t seed() const { return runSeed; }
+
+	// i in [0, size())
+	LogRecord const& at(int64_t i) const;
+
+private:
+	MappedFile file;
+	std::vector<uint64_t> scannedIndex;
+	uint64_t const* index = nullptr;
+	uint64_t blocks = 0;
+	int64_t count = 0;
+	uint32_t hz = 0;
+	uint32_t runSeed = 0;
+};
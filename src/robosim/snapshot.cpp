@@ -0,0 +1,123 @@
+#include "snapshot.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <tuple>
+
+// body ids for every snapshot in the process; 0 means not stamped yet
+static std::atomic<uintptr_t> nextBodyId{1};
+
+bool WorldSnapshot::ContactState::operator<(ContactState const& o) const {
+	return std::tie(fixtureA, fixtureB, childA, childB) < std::tie(o.fixtureA, o.fixtureB, o.childA, o.childB);
+}
+
+void WorldSnapshot::capture(Sim& sim) {
+	bodies.clear();
+	for (b2Body* b = sim.world.GetBodyList(); b; b = b->GetNext()) {
+		uintptr_t& id = b->GetUserData().pointer;
+		if (id == 0) {
+			id = nextBodyId.fetch_add(1, std::memory_order_relaxed);
+		}
+		bodies.push_back({
+			b,
+			id,
+			b->GetPosition(),
+			b->GetAngle(),
+			b->GetLinearVelocity(),
+			b->GetAngularVelocity(),
+			b->IsAwake(),
+			b->IsEnabled(),
+		});
+	}
+
+	contacts.clear();
+	for (b2Contact const* c = sim.world.GetContactList(); c; c = c->GetNext()) {
+		contacts.push_back({c->GetFixtureA(), c->GetFixtureB(), c->GetChildIndexA(), c->GetChildIndexB(), *c->GetManifold()});
+	}
+	// sorted once here so restore can binary search
+	std::sort(contacts.begin(), contacts.end());
+
+	bot = sim.bot;
+	input = sim.input;
+	tick = sim.tick;
+	maxErr = sim.maxErr;
+	odometer = sim.odometer;
+	lastIo = sim.lastIo;
+	if (sim.drivetrain) {
+		drivetrain = sim.drivetrain->state;
+	}
+	captured = true;
+}
+
+bool WorldSnapshot::restore(Sim& sim) const {
+	if (!captured) {
+		return false;
+	}
+
+	// the world's body list has to be exactly the one we saw: same bodies,
+	// not just new ones that landed at the same addresses
+	if (static_cast<size_t>(sim.world.GetBodyCount()) != bodies.size()) {
+		return false;
+	}
+	size_t i = 0;
+	for (b2Body* b = sim.world.GetBodyList(); b; b = b->GetNext(), i++) {
+		if (bodies[i].body != b || bodies[i].id != b->GetUserData().pointer) {
+			return false;
+		}
+	}
+
+	i = 0;
+	for (b2Body* b = sim.world.GetBodyList(); b; b = b->GetNext(), i++) {
+		BodyState const& s = bodies[i];
+
+		if (b->IsEnabled() != s.enabled) {
+			b->SetEnabled(s.enabled);
+		}
+
+		// SetTransform moves broadphase proxies, so skip bodies that haven't
+		// moved (static geometry, anything asleep the whole time)
+		if (b->GetPosition() != s.position || b->GetAngle() != s.angle) {
+			b->SetTransform(s.position, s.angle);
+		}
+
+		if (b->GetType() != b2_staticBody) {
+			b->SetAwake(s.awake);
+			if (s.awake) {
+				b->SetLinearVelocity(s.linearVelocity);
+				b->SetAngularVelocity(s.angularVelocity);
+			}
+		}
+	}
+
+	// contacts that exist again get their old impulses back; ones that don't
+	// yet will be found by the next step's broadphase and start cold
+	for (b2Contact* c = sim.world.GetContactList(); c; c = c->GetNext()) {
+		ContactState key{c->GetFixtureA(), c->GetFixtureB(), c->GetChildIndexA(), c->GetChildIndexB(), {}};
+		auto it = std::lower_bound(contacts.begin(), contacts.end(), key);
+		if (it != contacts.end() && !(key < *it)) {
+			*c->GetManifold() = it->manifold;
+		} else {
+			c->GetManifold()->pointCount = 0;
+		}
+	}
+
+	sim.bot = bot;
+	sim.bot.noise = &sim.noise;
+	sim.input = input;
+	sim.tick = tick;
+	sim.maxErr = maxErr;
+	sim.odometer = odometer;
+	sim.lastIo = lastIo;
+	if (sim.drivetrain) {
+		sim.drivetrain->state = drivetrain;
+	}
+
+	// the noise is counter-based, so putting the tick back is all the RNG
+	// state there is
+	sim.noise.tick = tick;
+	return true;
+}
+
+size_t WorldSnapshot::bytes() const {
+	return bodies.size() * sizeof(BodyState) + contacts.size() * sizeof(ContactState) + sizeof(*this);
+}
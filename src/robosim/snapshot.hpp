@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <box2d/box2d.h>
+
+#include "drivetrain.hpp"
+#include "sim.hpp"
+
+// Everything needed to put a Sim back where it was: body poses, velocities
+// and sleep state, contact manifolds (so the solver warm starts as if
+// nothing happened), the bot, the noise counter, and the drivetrain's held
+// targets and battery state when there is one. Buffers are reused across
+// captures, so snapshotting every tick doesn't allocate once warm.
+//
+// Restore only works on the Sim the snapshot came from, with the same set
+// of bodies; it returns false instead of guessing if bodies were added or
+// removed since. Box2D can hand a new body the address of a destroyed one,
+// so capture stamps every body with a unique id in its user data (which
+// nothing else uses) and restore checks those too. Box2D keeps a body's
+// time-to-sleep private, so a restored body starts that timer over.
+class WorldSnapshot {
+public:
+	// stamps any body that doesn't have an id yet
+	void capture(Sim& sim);
+	bool restore(Sim& sim) const;
+
+	bool empty() const { return !captured; }
+	size_t bytes() const;
+
+private:
+	struct BodyState {
+		b2Body const* body;
+		uintptr_t id;
+		b2Vec2 position;
+		float angle;
+		b2Vec2 linearVelocity;
+		float angularVelocity;
+		bool awake;
+		bool enabled;
+	};
+
+	struct ContactState {
+		b2Fixture const* fixtureA;
+		b2Fixture const* fixtureB;
+		int32 childA;
+		int32 childB;
+		b2Manifold manifold;
+
+		bool operator<(ContactState const& o) const;
+	};
+
+	std::vector<BodyState> bodies;
+	std::vector<ContactState> contacts;
+
+	Bot bot;
+	DriverInput input;
+	int64_t tick;
+	float maxErr;
+	double odometer;
+	Sim::RobotIo lastIo;
+	DrivetrainState drivetrain;
+	bool captured = false;
+};
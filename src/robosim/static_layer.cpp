@@ -0,0 +1,75 @@
+#include "static_layer.hpp"
+
+#include <rlgl.h>
+
+#include "b2DrawRayLib/b2DrawRayLib.hpp"
+
+// this rlgl doesn't name the GL blend constants
+constexpr int kGlZero = 0;
+constexpr int kGlOne = 1;
+constexpr int kGlFuncAdd = 0x8006;
+
+static bool sameCamera(Camera2D const& a, Camera2D const& b) {
+	return a.offset.x == b.offset.x && a.offset.y == b.offset.y
+		&& a.target.x == b.target.x && a.target.y == b.target.y
+		&& a.rotation == b.rotation && a.zoom == b.zoom;
+}
+
+void StaticLayer::redraw(RenderFrame const& frame, b2DrawRayLib& drawer, Camera2D const& cam, Color bg) {
+	int width = GetScreenWidth();
+	int height = GetScreenHeight();
+	if (texture.id == 0 || texture.texture.width != width || texture.texture.height != height) {
+		texture = raylib::RenderTexture(width, height);
+	}
+
+	// anything already recorded belongs on screen, not in the layer
+	if (drawer.IsBatching()) {
+		drawer.Flush();
+	}
+
+	BeginTextureMode(texture);
+	// opaque, so blitting it back is exactly what drawing directly gives
+	ClearBackground(bg);
+	if (frame.statics) {
+		BeginMode2D(cam);
+		b2AABB view = drawer.GetVisibleAABB(cam, static_cast<float>(width), static_cast<float>(height));
+		drawGeometry(*frame.statics, drawer, &view);
+		if (drawer.IsBatching()) {
+			drawer.Flush();
+		}
+		EndMode2D();
+	}
+	EndTextureMode();
+
+	staticVersion = frame.staticVersion;
+	camera = cam;
+	scale = drawer.GetScale();
+	flags = drawer.GetFlags();
+	background = bg;
+	valid = true;
+	redrawCount++;
+}
+
+void StaticLayer::draw(RenderFrame const& frame, b2DrawRayLib& drawer, Camera2D const& cam, Color bg) {
+	bool stale = !valid
+		|| frame.staticVersion != staticVersion
+		|| !sameCamera(cam, camera)
+		|| drawer.GetScale() != scale
+		|| drawer.GetFlags() != flags
+		|| ColorToInt(bg) != ColorToInt(background)
+		|| texture.texture.width != GetScreenWidth()
+		|| texture.texture.height != GetScreenHeight();
+	if (stale) {
+		redraw(frame, drawer, cam, bg);
+	}
+
+	// Translucent shapes blended over the clear color leave the texture's
+	// alpha below one, so copy it over the screen rather than blending it
+	// onto whatever the last frame left there. Render textures come out
+	// upside down.
+	Rectangle src{0, 0, static_cast<float>(texture.texture.width), -static_cast<float>(texture.texture.height)};
+	rlSetBlendFactors(kGlOne, kGlZero, kGlFuncAdd);
+	BeginBlendMode(BLEND_CUSTOM);
+	DrawTextureRec(texture.texture, src, {0, 0}, WHITE);
+	EndBlendMode();
+}
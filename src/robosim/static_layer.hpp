@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+
+#include <raylib.h>
+
+#include "raylib/RenderTexture.hpp"
+
+#include "render.hpp"
+
+class b2DrawRayLib;
+
+// Static bodies drawn once into an offscreen texture, which then stands in
+// for clearing the background: each frame is a single textured quad no
+// matter how many wall segments the field has. The texture is redrawn only
+// when the static geometry, the camera, the draw scale or flags, or the
+// window size change, and then only what's in view is drawn into it.
+class StaticLayer {
+public:
+	// clears to background and draws the frame's statics as seen through
+	// camera, from the cache when it's still good; call first thing after
+	// BeginDrawing and outside BeginMode2D
+	void draw(RenderFrame const& frame, b2DrawRayLib& drawer, Camera2D const& camera, Color background);
+
+	// forces a redraw next frame
+	void invalidate() { valid = false; }
+
+	// how many times the texture has been redrawn
+	int redraws() const { return redrawCount; }
+
+private:
+	void redraw(RenderFrame const& frame, b2DrawRayLib& drawer, Camera2D const& camera, Color background);
+
+	raylib::RenderTexture texture;
+	bool valid = false;
+	int redrawCount = 0;
+
+	// what the texture was drawn with
+	uint64_t staticVersion = 0;
+	Camera2D camera{};
+	float scale = 0;
+	uint32_t flags = 0;
+	Color background{};
+};
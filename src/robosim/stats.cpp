@@ -0,0 +1,15 @@
+#include "stats.hpp"
+
+#include <algorithm>
+
+Stats computeStats(std::vector<float> values) {
+	std::sort(values.begin(), values.end());
+
+	double sum = 0;
+	for (float v : values) {
+		sum += v;
+	}
+
+	size_t p95 = std::min(values.size() - 1, static_cast<size_t>(0.95 * values.size()));
+	return {sum / values.size(), values[p95], values.back()};
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <vector>
+
+struct Stats {
+	double mean;
+	float p95;
+	float max;
+};
+
+// values must not be empty
+Stats computeStats(std::vector<float> values);
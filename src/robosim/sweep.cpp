@@ -0,0 +1,78 @@
+#include "sweep.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include "botbatch.hpp"
+#include "robot.hpp"
+#include "sim.hpp"
+#include "simd.hpp"
+#include "stats.hpp"
+
+int runSweep(Options const& opts) {
+	size_t n = opts.sweep;
+	float timeStep = 1.0f / opts.physicsHz;
+	float damping = botDamping(timeStep);
+	float k = timeStep * kTuningRate;
+	int ticksPerPeriodic = opts.physicsHz / kRobotHz;
+	bool simd = !opts.noSimd && haveAvx2();
+
+	BotBatch bots;
+	bots.resize(n);
+	std::vector<SensorNoise> noise;
+	noise.reserve(n);
+	for (size_t i = 0; i < n; i++) {
+		bots.set(i, {0, 0, {kFieldWidth / 2.0f, kFieldHeight / 2.0f}, nullptr});
+		noise.emplace_back(opts.seed, i);
+	}
+	std::vector<float> maxErr(n, 0.0f);
+
+	DriverInput noInput{};
+	double integrateTime = 0;
+
+	auto start = std::chrono::steady_clock::now();
+	int64_t ticks = static_cast<int64_t>(opts.seconds * opts.physicsHz);
+	for (int64_t tick = 0; tick < ticks; tick++) {
+		if (tick % ticksPerPeriodic == 0) {
+			for (size_t i = 0; i < n; i++) {
+				Bot bot = bots.get(i);
+				bot.noise = &noise[i];
+				noise[i].tick = tick;
+				periodic(bot, noInput);
+				bots.set(i, bot);
+			}
+		}
+
+		auto integrateStart = std::chrono::steady_clock::now();
+		bots.integrate(damping, k, simd);
+		integrateTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - integrateStart).count();
+
+		for (size_t i = 0; i < n; i++) {
+			float dy = bots.posY[i] - kFieldHeight / 2;
+			float err = dy * dy;
+			if (err > maxErr[i]) {
+				maxErr[i] = err;
+			}
+		}
+	}
+	auto end = std::chrono::steady_clock::now();
+	double wall = std::chrono::duration<double>(end - start).count();
+
+	std::vector<float> errs(n);
+	for (size_t i = 0; i < n; i++) {
+		float dy = bots.posY[i] - kFieldHeight / 2;
+		errs[i] = dy * dy;
+	}
+	Stats errStats = computeStats(errs);
+	Stats maxErrStats = computeStats(maxErr);
+
+	double botSteps = static_cast<double>(n) * ticks;
+	printf("%zu bots for %.2f s at %d Hz in %.3f s wall (%s kinematics, base seed %u)\n", n, opts.seconds, opts.physicsHz, wall, simd ? "avx2" : "scalar", opts.seed);
+	printf("kinematics: %.1f M bot-steps/s (%.1f%% of wall time)\n", integrateTime > 0 ? botSteps / integrateTime / 1e6 : 0.0, 100.0 * integrateTime / wall);
+	printf("%-10s %14s %14s %14s\n", "", "mean", "p95", "max");
+	printf("%-10s %14f %14f %14f\n", "Err", errStats.mean, errStats.p95, errStats.max);
+	printf("%-10s %14f %14f %14f\n", "Max Err", maxErrStats.mean, maxErrStats.p95, maxErrStats.max);
+
+	return 0;
+}
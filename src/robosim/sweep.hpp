@@ -0,0 +1,7 @@
+#pragma once
+
+#include "options.hpp"
+
+// runs opts.sweep bots (no Box2D world) through the robot program in a
+// single BotBatch and reports error statistics and kinematics throughput
+int runSweep(Options const& opts);
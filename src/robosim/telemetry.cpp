@@ -0,0 +1,7 @@
+#include "telemetry.hpp"
+
+TelemetryChannel* Telemetry::add(std::string name, float hz, float bufferSeconds) {
+	size_t capacity = static_cast<size_t>(hz * bufferSeconds) + 1;
+	chans.push_back(std::make_unique<TelemetryChannel>(std::move(name), hz, capacity));
+	return chans.back().get();
+}
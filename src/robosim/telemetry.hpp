@@ -0,0 +1,92 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Single-producer/single-consumer ring. push and pop never lock or
+// allocate; capacity is rounded up to a power of two at construction.
+template <typename T>
+class SpscRing {
+public:
+	explicit SpscRing(size_t capacity) {
+		size_t n = 1;
+		while (n < capacity) {
+			n *= 2;
+		}
+		buf.resize(n);
+		mask = n - 1;
+	}
+
+	// producer side; returns false (dropping the item) if the consumer has
+	// fallen a whole ring behind
+	bool push(T const& item) {
+		size_t h = head.load(std::memory_order_relaxed);
+		if (h - tail.load(std::memory_order_acquire) > mask) {
+			return false;
+		}
+		buf[h & mask] = item;
+		head.store(h + 1, std::memory_order_release);
+		return true;
+	}
+
+	// consumer side
+	bool pop(T& item) {
+		size_t t = tail.load(std::memory_order_relaxed);
+		if (t == head.load(std::memory_order_acquire)) {
+			return false;
+		}
+		item = buf[t & mask];
+		tail.store(t + 1, std::memory_order_release);
+		return true;
+	}
+
+	size_t capacity() const { return mask + 1; }
+
+private:
+	std::vector<T> buf;
+	size_t mask;
+
+	// kept on separate cache lines so the two threads don't false-share
+	alignas(64) std::atomic<size_t> head{0};
+	alignas(64) std::atomic<size_t> tail{0};
+};
+
+struct TelemetrySample {
+	double t;
+	float value;
+};
+
+struct TelemetryChannel {
+	std::string name;
+	float hz;
+	SpscRing<TelemetrySample> ring;
+	std::atomic<uint64_t> dropped{0};
+
+	TelemetryChannel(std::string name, float hz, size_t capacity)
+		: name(std::move(name)), hz(hz), ring(capacity) {}
+
+	// called from the sim thread at whatever rate the channel runs
+	void publish(double t, float value) {
+		if (!ring.push({t, value})) {
+			dropped.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+};
+
+// Owns every channel. Channels are created up front (that's the only
+// allocation) and their addresses stay put, so the sim can hold raw
+// pointers to them.
+class Telemetry {
+public:
+	// the ring holds bufferSeconds of samples between consumer drains
+	TelemetryChannel* add(std::string name, float hz, float bufferSeconds = 1.0f);
+
+	std::vector<std::unique_ptr<TelemetryChannel>> const& channels() const { return chans; }
+
+private:
+	std::vector<std::unique_ptr<TelemetryChannel>> chans;
+};
@@ -0,0 +1,111 @@
+#include "telemetry_ui.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+
+#include "imgui.h"
+
+TelemetryPlots::TelemetryPlots(Telemetry& telemetry, float maxSeconds)
+	: maxSeconds(maxSeconds)
+{
+	for (auto const& chan : telemetry.channels()) {
+		History h;
+		h.channel = chan.get();
+		h.samples.resize(static_cast<size_t>(chan->hz * maxSeconds) + 1);
+		histories.push_back(std::move(h));
+	}
+}
+
+void TelemetryPlots::History::push(TelemetrySample const& s) {
+	if (count < samples.size()) {
+		samples[(start + count) % samples.size()] = s;
+		count++;
+	} else {
+		samples[start] = s;
+		start = (start + 1) % samples.size();
+	}
+}
+
+void TelemetryPlots::drain() {
+	for (auto& h : histories) {
+		TelemetrySample s;
+		while (h.channel->ring.pop(s)) {
+			h.push(s);
+		}
+	}
+}
+
+void TelemetryPlots::draw(double now) {
+	ImGui::Begin("Telemetry");
+	ImGui::SliderFloat("Window (s)", &windowSeconds, 1.0f, maxSeconds, "%.0f");
+
+	double from = now - windowSeconds;
+	int width = std::max(1, static_cast<int>(ImGui::GetContentRegionAvail().x * 0.65f));
+	columns.resize(2 * width);
+
+	for (auto const& h : histories) {
+		if (h.count == 0) {
+			ImGui::Text("%s: no data", h.channel->name.c_str());
+			continue;
+		}
+
+		// each pixel column gets the min and max of the samples that fall in
+		// it; the plot zigzags between them, which reads as a filled band
+		// newest first, stopping at the window's start, so a short window
+		// over a long 1 kHz history only touches the samples it shows
+		std::fill(columns.begin(), columns.end(), NAN);
+		float lo = FLT_MAX;
+		float hi = -FLT_MAX;
+		for (size_t i = h.count; i-- > 0;) {
+			auto const& s = h.at(i);
+			if (s.t < from) {
+				break;
+			}
+			// anything past now is from before a snapshot restore
+			if (s.t > now) {
+				continue;
+			}
+			int col = std::min(width - 1, static_cast<int>((s.t - from) / windowSeconds * width));
+			float& mn = columns[2 * col];
+			float& mx = columns[2 * col + 1];
+			mn = std::isnan(mn) ? s.value : std::min(mn, s.value);
+			mx = std::isnan(mx) ? s.value : std::max(mx, s.value);
+			lo = std::min(lo, s.value);
+			hi = std::max(hi, s.value);
+		}
+		if (lo > hi) {
+			ImGui::Text("%s: no data in the window", h.channel->name.c_str());
+			continue;
+		}
+
+		// carry the last value through columns with no samples so slow
+		// channels draw as steps rather than gaps
+		float last = NAN;
+		for (float& v : columns) {
+			if (std::isnan(v)) {
+				v = last;
+			} else {
+				last = v;
+			}
+		}
+		for (float& v : columns) {
+			if (std::isnan(v)) {
+				v = lo;
+			}
+		}
+
+		float latest = h.at(h.count - 1).value;
+		char overlay[64];
+		snprintf(overlay, sizeof(overlay), "%.3f  [%.3f, %.3f]", latest, lo, hi);
+		ImGui::PlotLines(h.channel->name.c_str(), columns.data(), static_cast<int>(columns.size()), 0, overlay, lo, hi == lo ? lo + 1 : hi, {static_cast<float>(width), 60});
+
+		uint64_t dropped = h.channel->dropped.load(std::memory_order_relaxed);
+		if (dropped > 0) {
+			ImGui::TextDisabled("  %llu samples dropped", static_cast<unsigned long long>(dropped));
+		}
+	}
+
+	ImGui::End();
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <vector>
+
+#include "telemetry.hpp"
+
+// The UI end of Telemetry: drains every channel into a preallocated
+// history and draws scrolling plots of the last few seconds. Plots are
+// min/max decimated to one column per pixel, so a 1 kHz channel costs the
+// same to draw as a 50 Hz one.
+class TelemetryPlots {
+public:
+	TelemetryPlots(Telemetry& telemetry, float maxSeconds = 30.0f);
+
+	// pulls everything published since the last call; consumer thread only
+	void drain();
+
+	// draws an ImGui window with one plot per channel
+	void draw(double now);
+
+private:
+	struct History {
+		TelemetryChannel* channel;
+		std::vector<TelemetrySample> samples;
+		size_t start = 0;
+		size_t count = 0;
+
+		TelemetrySample const& at(size_t i) const { return samples[(start + i) % samples.size()]; }
+		void push(TelemetrySample const& s);
+	};
+
+	std::vector<History> histories;
+	std::vector<float> columns;
+	float maxSeconds;
+	float windowSeconds = 10.0f;
+};
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// Lock-free single-writer/single-reader triple buffer. The writer fills
+// back() and publish()es it; the reader calls acquire() and gets the newest
+// published value, which stays put until its next acquire(). Neither side
+// ever waits on the other, and an unread value is simply replaced by a
+// newer one. Slots are reused, so a T that keeps its vectors' capacity
+// stops allocating once every slot has seen a full-size value.
+template <typename T>
+class TripleBuffer {
+public:
+	// writer side
+	T& back() { return slots[backIndex]; }
+
+	void publish() {
+		uint8_t old = middle.exchange(backIndex | kFresh, std::memory_order_acq_rel);
+		backIndex = old & kIndexMask;
+	}
+
+	// reader side; returns the latest value, or the previous one again if
+	// nothing new was published since
+	T const& acquire() {
+		if (middle.load(std::memory_order_relaxed) & kFresh) {
+			uint8_t old = middle.exchange(frontIndex, std::memory_order_acq_rel);
+			frontIndex = old & kIndexMask;
+		}
+		return slots[frontIndex];
+	}
+
+	// the value the last acquire() returned
+	T const& front() const { return slots[frontIndex]; }
+
+private:
+	static constexpr uint8_t kIndexMask = 0x3;
+	static constexpr uint8_t kFresh = 0x4;
+
+	T slots[3];
+
+	// each index is owned by exactly one of the three roles at a time
+	alignas(64) uint8_t backIndex = 0;
+	alignas(64) std::atomic<uint8_t> middle{1};
+	alignas(64) uint8_t frontIndex = 2;
+};
@@ -0,0 +1,138 @@
+#include "vision.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "field.hpp"
+#include "profiler.hpp"
+#include "segment_bvh.hpp"
+#include "sim.hpp"
+
+Vision::Vision(Field const& field, SegmentBvh const& edges, int physicsHz)
+	: edges(edges)
+	, physicsHz(physicsHz)
+{
+	tags = field.tags(tagCount);
+}
+
+int Vision::addCamera(b2Body const* body, SensorNoise const& noise, CameraConfig const& config) {
+	Camera& cam = cameras.emplace_back();
+	cam.body = body;
+	cam.noise = &noise;
+	cam.config = config;
+	cam.cosHalfFov = std::cos(config.fov / 2);
+	cam.cosIncidence = std::cos(config.maxIncidence);
+	cam.ticksPerFrame = std::max(1, static_cast<int>(std::lround(physicsHz / config.fps)));
+	cam.latencyTicks = static_cast<int>(std::lround(config.latency * physicsHz));
+
+	// the frames still in flight, plus the one being handed out
+	cam.depth = cam.latencyTicks / cam.ticksPerFrame + 2;
+	cam.ticks.assign(cam.depth, -1);
+	cam.counts.assign(cam.depth, 0);
+	cam.sightings.resize(cam.depth * tagCount);
+
+	size_t lines = cameras.size() * tagCount;
+	candidates.reserve(lines);
+	from.reserve(lines);
+	to.reserve(lines);
+	blocked = std::make_unique<bool[]>(lines);
+
+	return static_cast<int>(cameras.size()) - 1;
+}
+
+void Vision::capture(int64_t tick) {
+	PROFILE_ZONE("Vision::capture");
+
+	// every tag in every due camera's frustum, range and decodable angle
+	candidates.clear();
+	from.clear();
+	to.clear();
+	for (int c = 0; c < static_cast<int>(cameras.size()); c++) {
+		Camera& cam = cameras[c];
+		if (tick % cam.ticksPerFrame != 0) {
+			continue;
+		}
+		CameraConfig const& config = cam.config;
+		b2Transform const& xf = cam.body->GetTransform();
+		b2Vec2 lens = b2Mul(xf, config.mount);
+		float heading = xf.q.GetAngle() + config.yaw;
+		b2Vec2 axis(std::cos(heading), std::sin(heading));
+		float tanHalfVertical = std::tan(config.verticalFov / 2);
+
+		for (uint32_t t = 0; t < tagCount; t++) {
+			FieldTag const& tag = tags[t];
+			b2Vec2 d(tag.x - lens.x, tag.y - lens.y);
+			float range = d.Length();
+			if (range > config.range || range < b2_epsilon) {
+				continue;
+			}
+			// inside the horizontal fov: the angle off the axis is under half of it
+			if (b2Dot(d, axis) < cam.cosHalfFov * range) {
+				continue;
+			}
+			if (std::abs(tag.z - config.height) > tanHalfVertical * range) {
+				continue;
+			}
+			// the tag's face points back toward the lens closely enough
+			b2Vec2 normal(std::cos(tag.yaw), std::sin(tag.yaw));
+			if (-b2Dot(d, normal) < cam.cosIncidence * range) {
+				continue;
+			}
+
+			float bearing = std::remainder(std::atan2(d.y, d.x) - heading, 2 * b2_pi);
+			float yaw = std::remainder(tag.yaw - heading, 2 * b2_pi);
+			candidates.push_back({c, t, range, bearing, yaw});
+			from.push_back(lens);
+			to.push_back({tag.x, tag.y});
+		}
+	}
+
+	int n = static_cast<int>(candidates.size());
+	edges.blocked(from.data(), to.data(), n, blocked.get());
+	sightLines += n;
+
+	// start a frame on every due camera, then fill them with what's visible
+	for (Camera& cam : cameras) {
+		if (tick % cam.ticksPerFrame == 0) {
+			cam.next = (cam.next + 1) % cam.depth;
+			cam.ticks[cam.next] = tick;
+			cam.counts[cam.next] = 0;
+			frames++;
+		}
+	}
+	for (int i = 0; i < n; i++) {
+		if (blocked[i]) {
+			continue;
+		}
+		Candidate const& cand = candidates[i];
+		Camera& cam = cameras[cand.camera];
+		CameraConfig const& config = cam.config;
+
+		// one block per (camera, tag), read at this tick
+		SensorNoise noise = *cam.noise;
+		noise.tick = static_cast<uint64_t>(tick);
+		float g[4];
+		noise.fillNormals(kSensorCamera + (cand.camera * tagCount + cand.tag) * 4, g, 4);
+
+		TagSighting& s = cam.sightings[cam.next * tagCount + cam.counts[cam.next]++];
+		s.tag = tags[cand.tag].id;
+		s.range = std::max(0.0f, cand.range * (1 + config.rangeStddev * g[0]));
+		s.bearing = cand.bearing + config.bearingStddev * g[1];
+		s.yaw = std::remainder(cand.yaw + config.yawStddev * g[2], 2 * b2_pi);
+		sightings++;
+	}
+}
+
+CameraFrame Vision::frame(int camera, int64_t tick) const {
+	Camera const& cam = cameras[camera];
+	CameraFrame newest;
+	for (int k = 0; k < cam.depth; k++) {
+		int64_t exposed = cam.ticks[k];
+		if (exposed >= 0 && exposed + cam.latencyTicks <= tick && exposed > newest.tick) {
+			newest.tick = exposed;
+			newest.count = cam.counts[k];
+			newest.sightings = cam.sightings.data() + k * tagCount;
+		}
+	}
+	return newest;
+}
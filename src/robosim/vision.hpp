@@ -0,0 +1,124 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <box2d/box2d.h>
+
+class Field;
+class SegmentBvh;
+struct FieldTag;
+struct SensorNoise;
+
+struct CameraConfig {
+	// where it's mounted on the chassis, in the body's frame
+	b2Vec2 mount = {0, 0};   // m
+	float yaw = 0;           // radians, 0 looks straight ahead
+	float height = 0.5f;     // m, lens above the carpet
+
+	float fov = 1.22f;          // radians across, about 70 degrees
+	float verticalFov = 0.85f;  // radians top to bottom, about 49 degrees
+	float range = 6.0f;         // m; tags further out are too small to decode
+
+	// a tag seen more edge-on than this can't be decoded
+	float maxIncidence = 1.13f; // radians, about 65 degrees
+
+	float fps = 30.0f;
+	float latency = 0.05f;   // s from exposure until the robot has the result
+
+	float rangeStddev = 0.02f;    // as a fraction of the range
+	float bearingStddev = 0.005f; // radians
+	float yawStddev = 0.05f;      // radians
+};
+
+// One tag in one frame, relative to the camera that saw it.
+struct TagSighting {
+	int32_t tag;       // the field's tag id
+	float range;       // m, lens to tag center across the floor
+	float bearing;     // radians, counterclockwise from the camera's axis
+	float yaw;         // radians, the tag's facing relative to the camera's
+};
+
+// Everything a camera decoded from one exposure.
+struct CameraFrame {
+	int64_t tick = -1;   // when it was exposed; -1 for no frame yet
+	int count = 0;
+	TagSighting const* sightings = nullptr;
+};
+
+// Simulated AprilTag cameras for every robot at once. Each capture works
+// out, for every camera due a frame, which field tags are inside its
+// frustum and range and facing it, then tests all of those sight lines
+// against the field's edges in one batch, so there's one pass over the
+// BVH per tick rather than one per camera. Sightings get range, bearing and
+// yaw noise from the robot's SensorNoise, one philox block per (camera,
+// tag), so a frame depends only on the seed and the tick.
+//
+// Frames are held back by the camera's latency before frame() hands them
+// out. Each camera keeps just enough of them in a fixed ring, and all the
+// sight line scratch is sized up front, so capture() doesn't allocate.
+//
+// Only the field occludes tags; other robots don't.
+class Vision {
+public:
+	// field and edges must outlive this; edges built from field
+	Vision(Field const& field, SegmentBvh const& edges, int physicsHz);
+
+	// a camera on body, whose noise it takes its samples from; both must
+	// outlive this. Returns the camera's index.
+	int addCamera(b2Body const* body, SensorNoise const& noise, CameraConfig const& config);
+
+	// exposes every camera that's due a frame this tick
+	void capture(int64_t tick);
+
+	// the newest frame whose latency has passed by tick
+	CameraFrame frame(int camera, int64_t tick) const;
+
+	int cameraCount() const { return static_cast<int>(cameras.size()); }
+
+	// running totals, for reporting
+	int64_t frames = 0;
+	int64_t sightLines = 0;
+	int64_t sightings = 0;
+
+private:
+	struct Camera {
+		b2Body const* body;
+		SensorNoise const* noise;
+		CameraConfig config;
+		float cosHalfFov;
+		float cosIncidence;
+		int ticksPerFrame;
+		int latencyTicks;
+
+		// ring of depth frames; slot k's sightings start at k * tagCount
+		int depth;
+		int next = 0;
+		std::vector<int64_t> ticks;
+		std::vector<int> counts;
+		std::vector<TagSighting> sightings;
+	};
+
+	// a tag that passed the frustum checks, waiting on its occlusion test
+	struct Candidate {
+		int camera;
+		uint32_t tag;
+		float range;
+		float bearing;
+		float yaw;
+	};
+
+	FieldTag const* tags;
+	uint32_t tagCount;
+	SegmentBvh const& edges;
+	int physicsHz;
+
+	std::vector<Camera> cameras;
+
+	// one sight line per candidate, for the batched occlusion test
+	std::vector<Candidate> candidates;
+	std::vector<b2Vec2> from;
+	std::vector<b2Vec2> to;
+	std::unique_ptr<bool[]> blocked;
+};